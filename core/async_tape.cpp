@@ -0,0 +1,36 @@
+#include "async_tape.h"
+
+AsyncTapeAdapter::AsyncTapeAdapter(ITape& tape, EventLoop& loop, TapeDelays const& delays)
+    : tape_(tape), loop_(loop), delays_(delays) {}
+
+AsyncTapeAdapter::AsyncTapeAdapter(std::unique_ptr<ITape> tape, EventLoop& loop,
+                                   TapeDelays const& delays)
+    : owned_tape_(std::move(tape)), tape_(*owned_tape_), loop_(loop), delays_(delays) {}
+
+Task<bool> AsyncTapeAdapter::Read(int32_t& value) {
+    co_await loop_.Sleep(delays_.read_delay_ms_);
+    co_return tape_.Read(value);
+}
+
+Task<void> AsyncTapeAdapter::Write(int32_t value) {
+    co_await loop_.Sleep(delays_.write_delay_ms_);
+    tape_.Write(value);
+}
+
+Task<void> AsyncTapeAdapter::Move(MoveDirection direction) {
+    co_await loop_.Sleep(delays_.move_delay_ms_);
+    tape_.Move(direction);
+}
+
+Task<void> AsyncTapeAdapter::Rewind() {
+    co_await loop_.Sleep(delays_.rewind_delay_ms_);
+    tape_.Rewind();
+}
+
+AsyncTapeFactoryAdapter::AsyncTapeFactoryAdapter(std::unique_ptr<ITapeFactory> factory,
+                                                 EventLoop& loop, TapeDelays const& delays)
+    : factory_(std::move(factory)), loop_(loop), delays_(delays) {}
+
+std::unique_ptr<AsyncTape> AsyncTapeFactoryAdapter::Create() {
+    return std::make_unique<AsyncTapeAdapter>(factory_->Create(), loop_, delays_);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+#include "event_loop.h"
+#include "i_tape.h"
+#include "tape_config.h"
+#include "task.h"
+#include "tmp_tape_factory.h"
+
+// Asynchronous counterpart of ITape: every operation is a coroutine that completes once the
+// simulated device has finished it.
+class AsyncTape {
+public:
+    virtual ~AsyncTape() = default;
+
+    virtual Task<bool> Read(int32_t& value) = 0;
+    virtual Task<void> Write(int32_t value) = 0;
+    virtual Task<void> Move(MoveDirection direction) = 0;
+    virtual Task<void> Rewind() = 0;
+};
+
+// Runs a synchronous tape on an event loop. The delays are waited for on the loop instead of
+// blocking the thread, so the wrapped tape is expected to have no delays of its own.
+class AsyncTapeAdapter : public AsyncTape {
+public:
+    AsyncTapeAdapter(ITape& tape, EventLoop& loop, TapeDelays const& delays);
+    AsyncTapeAdapter(std::unique_ptr<ITape> tape, EventLoop& loop, TapeDelays const& delays);
+
+    Task<bool> Read(int32_t& value) override;
+    Task<void> Write(int32_t value) override;
+    Task<void> Move(MoveDirection direction) override;
+    Task<void> Rewind() override;
+
+private:
+    std::unique_ptr<ITape> owned_tape_;
+    ITape& tape_;
+    EventLoop& loop_;
+    TapeDelays delays_;
+};
+
+class AsyncTapeFactory {
+public:
+    virtual ~AsyncTapeFactory() = default;
+    virtual std::unique_ptr<AsyncTape> Create() = 0;
+};
+
+class AsyncTapeFactoryAdapter : public AsyncTapeFactory {
+public:
+    AsyncTapeFactoryAdapter(std::unique_ptr<ITapeFactory> factory, EventLoop& loop,
+                            TapeDelays const& delays);
+
+    std::unique_ptr<AsyncTape> Create() override;
+
+private:
+    std::unique_ptr<ITapeFactory> factory_;
+    EventLoop& loop_;
+    TapeDelays delays_;
+};
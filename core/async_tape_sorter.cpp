@@ -0,0 +1,115 @@
+#include "async_tape_sorter.h"
+
+#include <algorithm>
+#include <queue>
+
+Task<std::vector<AsyncTapeSorter::Run>> AsyncTapeSorter::Split(AsyncTape& input_tape) const {
+    std::vector<Run> runs;
+
+    std::vector<int32_t> buffer;
+    buffer.reserve(memory_block_);
+    co_await ReadBlock(input_tape, buffer, memory_block_);
+
+    while (!buffer.empty()) {
+        std::sort(buffer.begin(), buffer.end(), std::greater<>());
+        auto tmp_tape = factory_->Create();
+
+        std::vector<int32_t> next_buffer;
+        next_buffer.reserve(memory_block_);
+
+        std::vector<Task<void>> operations;
+        operations.push_back(WriteRun(*tmp_tape, buffer));
+        operations.push_back(ReadBlock(input_tape, next_buffer, memory_block_));
+        co_await WhenAll(std::move(operations));
+
+        runs.push_back({std::move(tmp_tape), buffer.size()});
+        buffer = std::move(next_buffer);
+    }
+
+    co_return runs;
+}
+
+Task<void> AsyncTapeSorter::Merge(std::vector<Run>& runs, AsyncTape& output_tape) {
+    using Element = std::pair<int32_t, size_t>;
+    std::priority_queue<Element, std::vector<Element>, std::greater<>> heap;
+
+    std::vector<size_t> remaining;
+    std::vector<std::optional<int32_t>> heads(runs.size());
+    std::vector<Task<void>> reads;
+    remaining.reserve(runs.size());
+    for (auto const& run : runs) {
+        remaining.push_back(run.length);
+    }
+    for (size_t idx = 0; idx < runs.size(); ++idx) {
+        reads.push_back(ReadBackward(*runs[idx].tape, remaining[idx], heads[idx]));
+    }
+    co_await WhenAll(std::move(reads));
+
+    for (size_t idx = 0; idx < heads.size(); ++idx) {
+        if (heads[idx]) {
+            heap.emplace(*heads[idx], idx);
+        }
+    }
+
+    while (!heap.empty()) {
+        auto [current_val, run_idx] = heap.top();
+        heap.pop();
+
+        std::optional<int32_t> next_val;
+        std::vector<Task<void>> operations;
+        operations.push_back(WriteNext(output_tape, current_val));
+        operations.push_back(ReadBackward(*runs[run_idx].tape, remaining[run_idx], next_val));
+        co_await WhenAll(std::move(operations));
+
+        if (next_val) {
+            heap.emplace(*next_val, run_idx);
+        }
+    }
+}
+
+Task<void> AsyncTapeSorter::Sort(AsyncTape& input_tape, AsyncTape& output_tape) const {
+    co_await input_tape.Rewind();
+    auto runs = co_await Split(input_tape);
+    if (runs.empty()) {
+        co_return;
+    }
+
+    co_await output_tape.Rewind();
+    co_await Merge(runs, output_tape);
+}
+
+Task<void> AsyncTapeSorter::ReadBlock(AsyncTape& tape, std::vector<int32_t>& block,
+                                      size_t const size) {
+    int32_t value;
+    while (block.size() < size && co_await tape.Read(value)) {
+        block.push_back(value);
+        co_await tape.Move(MoveDirection::kForward);
+    }
+}
+
+Task<void> AsyncTapeSorter::WriteRun(AsyncTape& tape, std::vector<int32_t> const& values) {
+    for (auto const& value : values) {
+        co_await tape.Write(value);
+        co_await tape.Move(MoveDirection::kForward);
+    }
+}
+
+Task<void> AsyncTapeSorter::ReadBackward(AsyncTape& tape, size_t& remaining,
+                                         std::optional<int32_t>& value) {
+    value.reset();
+    if (remaining == 0) {
+        co_return;
+    }
+    co_await tape.Move(MoveDirection::kBackward);
+    int32_t next;
+    if (!co_await tape.Read(next)) {
+        throw std::runtime_error("Temporary tape is shorter than its run");
+    }
+    value = next;
+    --remaining;
+}
+
+Task<void> AsyncTapeSorter::WriteNext(AsyncTape& tape, int32_t const value) {
+    co_await tape.Write(value);
+    co_await tape.Move(MoveDirection::kForward);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "async_tape.h"
+
+// Coroutine version of TapeSorter. Independent tape operations (writing a run while reading the
+// next block, writing the output while refilling the merge) are awaited together, so a single
+// thread drives all tapes concurrently.
+class AsyncTapeSorter {
+public:
+    AsyncTapeSorter(size_t const memory_block, std::unique_ptr<AsyncTapeFactory> factory)
+        : memory_block_(memory_block), factory_(std::move(factory)) {}
+
+    Task<void> Sort(AsyncTape& input_tape, AsyncTape& output_tape) const;
+
+private:
+    // Sorted run written in descending order and read backward by the merge, as in TapeSorter.
+    struct Run {
+        std::unique_ptr<AsyncTape> tape;
+        size_t length;
+    };
+
+    size_t memory_block_;
+    std::unique_ptr<AsyncTapeFactory> factory_;
+
+    static Task<void> Merge(std::vector<Run>& runs, AsyncTape& output_tape);
+
+    Task<std::vector<Run>> Split(AsyncTape& input_tape) const;
+
+    static Task<void> ReadBlock(AsyncTape& tape, std::vector<int32_t>& block, size_t size);
+    static Task<void> WriteRun(AsyncTape& tape, std::vector<int32_t> const& values);
+    static Task<void> ReadBackward(AsyncTape& tape, size_t& remaining,
+                                   std::optional<int32_t>& value);
+    static Task<void> WriteNext(AsyncTape& tape, int32_t value);
+};
@@ -0,0 +1,131 @@
+#include "checksum.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define TAPE_SORTER_CRC32C_SSE42
+#endif
+
+namespace {
+constexpr uint32_t kCrc32cPolynomial = 0x82F63B78;
+
+constexpr std::array<uint32_t, 256> MakeCrc32cTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t byte = 0; byte < table.size(); ++byte) {
+        uint32_t crc = byte;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) != 0 ? kCrc32cPolynomial : 0);
+        }
+        table[byte] = crc;
+    }
+    return table;
+}
+
+constexpr auto kCrc32cTable = MakeCrc32cTable();
+
+#ifdef TAPE_SORTER_CRC32C_SSE42
+__attribute__((target("sse4.2"))) uint32_t Crc32cSse42(void const* data, size_t size,
+                                                       uint32_t const crc) {
+    auto const* bytes = static_cast<unsigned char const*>(data);
+    uint64_t state = ~crc;
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), bytes += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        state = _mm_crc32_u64(state, word);
+    }
+    auto narrow = static_cast<uint32_t>(state);
+    for (; size > 0; --size, ++bytes) {
+        narrow = _mm_crc32_u8(narrow, *bytes);
+    }
+    return ~narrow;
+}
+#endif
+}  // namespace
+
+uint32_t Crc32cPortable(void const* data, size_t size, uint32_t const crc) {
+    auto const* bytes = static_cast<unsigned char const*>(data);
+    uint32_t state = ~crc;
+    for (; size > 0; --size, ++bytes) {
+        state = (state >> 8) ^ kCrc32cTable[(state ^ *bytes) & 0xFF];
+    }
+    return ~state;
+}
+
+bool Crc32cHardwareAvailable() {
+#ifdef TAPE_SORTER_CRC32C_SSE42
+    static bool const available = __builtin_cpu_supports("sse4.2");
+    return available;
+#else
+    return false;
+#endif
+}
+
+uint32_t Crc32c(void const* data, size_t const size, uint32_t const crc) {
+#ifdef TAPE_SORTER_CRC32C_SSE42
+    if (Crc32cHardwareAvailable()) {
+        return Crc32cSse42(data, size, crc);
+    }
+#endif
+    return Crc32cPortable(data, size, crc);
+}
+
+uint64_t MixBits(uint64_t value) {
+    value += 0x9E3779B97F4A7C15;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+SortVerifier::SortVerifier(size_t const cells_per_element)
+    : cells_per_element_(cells_per_element) {
+    if (cells_per_element_ == 0) {
+        throw std::invalid_argument("An element must have at least one cell");
+    }
+}
+
+bool SortVerifier::Append(Element& element, int32_t const cell) const {
+    element.hash = std::rotl(element.hash, 32) ^ static_cast<uint32_t>(cell);
+    return ++element.cells == cells_per_element_;
+}
+
+void SortVerifier::AddInput(int32_t const cell) {
+    if (Append(input_element_, cell)) {
+        input_.Add(input_element_.hash);
+        input_element_ = {};
+    }
+}
+
+void SortVerifier::AddOutput(int32_t const cell) {
+    if (output_element_.cells == 0) {
+        if (output_.Count() > 0 && cell < output_key_ && unsorted_at_ == 0) {
+            unsorted_at_ = output_.Count();
+        }
+        output_key_ = cell;
+    }
+    if (Append(output_element_, cell)) {
+        output_.Add(output_element_.hash);
+        output_element_ = {};
+    }
+}
+
+void SortVerifier::Check() const {
+    if (unsorted_at_ != 0) {
+        throw std::runtime_error("Output is not sorted at element " +
+                                 std::to_string(unsorted_at_));
+    }
+    if (input_element_.cells != 0 || output_element_.cells != 0) {
+        throw std::runtime_error("Tape ends in the middle of an element");
+    }
+    if (input_.Count() != output_.Count()) {
+        throw std::runtime_error("Output has " + std::to_string(output_.Count()) +
+                                 " elements, input has " + std::to_string(input_.Count()));
+    }
+    if (!(input_ == output_)) {
+        throw std::runtime_error("Output is not a permutation of the input");
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// CRC32C (Castagnoli). Uses the SSE4.2 instruction when the CPU supports it. Pass the previous
+// result as crc to checksum data in pieces.
+uint32_t Crc32c(void const* data, size_t size, uint32_t crc = 0);
+
+// Table-driven CRC32C, the fallback of Crc32c.
+uint32_t Crc32cPortable(void const* data, size_t size, uint32_t crc = 0);
+
+bool Crc32cHardwareAvailable();
+
+// SplitMix64 finalizer: a bijective mix in which every output bit depends non-linearly on every
+// input bit.
+uint64_t MixBits(uint64_t value);
+
+// Order-independent hash of a multiset of elements. Equal multisets give equal hashes whatever
+// order the elements are added in.
+class MultisetHash {
+public:
+    void Add(uint64_t element) {
+        sum_ += MixBits(element);
+        ++count_;
+    }
+
+    [[nodiscard]] size_t Count() const {
+        return count_;
+    }
+
+    bool operator==(MultisetHash const& other) const = default;
+
+private:
+    uint64_t sum_ = 0;
+    size_t count_ = 0;
+};
+
+// Streaming check that an output is sorted and is a permutation of the input. An element is
+// cells_per_element consecutive cells ordered by the first one.
+class SortVerifier {
+public:
+    explicit SortVerifier(size_t cells_per_element = 1);
+
+    void AddInput(int32_t cell);
+    void AddOutput(int32_t cell);
+
+    // Throws std::runtime_error if the output is out of order or holds other elements.
+    void Check() const;
+
+private:
+    struct Element {
+        uint64_t hash = 0;
+        size_t cells = 0;
+    };
+
+    size_t cells_per_element_;
+    Element input_element_;
+    Element output_element_;
+    MultisetHash input_;
+    MultisetHash output_;
+    int32_t output_key_ = 0;
+    size_t unsorted_at_ = 0;
+
+    bool Append(Element& element, int32_t cell) const;
+};
@@ -0,0 +1,80 @@
+#include "checksum_tape.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "checksum.h"
+
+ChecksumTape::ChecksumTape(std::unique_ptr<ITape> tape, MemoryBudget* budget)
+    : tape_(std::move(tape)), block_checksums_(BudgetAllocator<uint32_t>(budget)) {}
+
+uint32_t ChecksumTape::CellChecksum(size_t const position, int32_t const value) {
+    uint64_t const cell = static_cast<uint64_t>(position) << 32 | static_cast<uint32_t>(value);
+    // CRC32C is affine, so without the mix a swap of two cells or the same bit flipped in two
+    // cells would leave the XOR over the block unchanged.
+    return static_cast<uint32_t>(MixBits(Crc32c(&cell, sizeof(cell))) >> 32);
+}
+
+bool ChecksumTape::Read(int32_t& value) {
+    if (!tape_->Read(value)) {
+        return false;
+    }
+    if (position_ >= size_) {
+        throw std::runtime_error("Temporary tape holds a cell that was never written");
+    }
+
+    size_t const block = position_ / kBlockCells;
+    if (block != read_block_) {
+        read_block_ = block;
+        read_cells_ = 0;
+        read_checksum_ = 0;
+    }
+    read_checksum_ ^= CellChecksum(position_, value);
+
+    size_t const block_cells = std::min(kBlockCells, size_ - block * kBlockCells);
+    if (++read_cells_ == block_cells) {
+        if (read_checksum_ != block_checksums_[block]) {
+            throw std::runtime_error("Checksum mismatch in block " + std::to_string(block) +
+                                     " of a temporary tape");
+        }
+        read_block_ = kNoBlock;
+    }
+    return true;
+}
+
+void ChecksumTape::Write(int32_t const value) {
+    if (position_ != size_) {
+        throw std::runtime_error("Checksummed tapes can only be appended to");
+    }
+    tape_->Write(value);
+
+    if (position_ % kBlockCells == 0) {
+        block_checksums_.push_back(0);
+    }
+    block_checksums_.back() ^= CellChecksum(position_, value);
+    ++size_;
+}
+
+void ChecksumTape::Move(MoveDirection const direction) {
+    tape_->Move(direction);
+    if (direction == MoveDirection::kForward) {
+        ++position_;
+    } else {
+        --position_;
+    }
+}
+
+void ChecksumTape::Rewind() {
+    tape_->Rewind();
+    position_ = 0;
+    read_block_ = kNoBlock;
+}
+
+ChecksumTapeFactory::ChecksumTapeFactory(std::unique_ptr<ITapeFactory> factory,
+                                         MemoryBudget* budget)
+    : factory_(std::move(factory)), budget_(budget) {}
+
+std::unique_ptr<ITape> ChecksumTapeFactory::Create() {
+    return std::make_unique<ChecksumTape>(factory_->Create(), budget_);
+}
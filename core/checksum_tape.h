@@ -0,0 +1,50 @@
+#pragma once
+#include <memory>
+
+#include "i_tape.h"
+#include "memory_budget.h"
+#include "tmp_tape_factory.h"
+
+// Keeps a checksum of every block of kBlockCells cells written to the wrapped tape and verifies a
+// block once all of its cells are read back, in either direction. A cell checksum is the CRC32C
+// of its value and position passed through a non-linear mix, XORed over the block so the read
+// order does not matter.
+// Cells are written once, in order, as temp tapes are, and read at most once between rewinds.
+class ChecksumTape : public ITape {
+public:
+    static constexpr size_t kBlockCells = 1024;
+
+    explicit ChecksumTape(std::unique_ptr<ITape> tape, MemoryBudget* budget = nullptr);
+
+    bool Read(int32_t& value) override;
+    void Write(int32_t value) override;
+    void Move(MoveDirection direction) override;
+    void Rewind() override;
+
+private:
+    static constexpr size_t kNoBlock = static_cast<size_t>(-1);
+
+    std::unique_ptr<ITape> tape_;
+    BudgetVector<uint32_t> block_checksums_;
+    size_t position_ = 0;
+    size_t size_ = 0;
+
+    size_t read_block_ = kNoBlock;
+    size_t read_cells_ = 0;
+    uint32_t read_checksum_ = 0;
+
+    static uint32_t CellChecksum(size_t position, int32_t value);
+};
+
+// Wraps every tape created by the inner factory into a ChecksumTape.
+class ChecksumTapeFactory : public ITapeFactory {
+public:
+    explicit ChecksumTapeFactory(std::unique_ptr<ITapeFactory> factory,
+                                 MemoryBudget* budget = nullptr);
+
+    std::unique_ptr<ITape> Create() override;
+
+private:
+    std::unique_ptr<ITapeFactory> factory_;
+    MemoryBudget* budget_;
+};
@@ -0,0 +1,191 @@
+#include "direct_tape.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+std::runtime_error IoError(std::string const& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+}  // namespace
+
+int OpenUncached(std::string const& file_name, bool& direct) {
+#ifdef O_DIRECT
+    int const fd = open(file_name.c_str(), O_RDWR | O_DIRECT);
+    if (fd >= 0) {
+        direct = true;
+        return fd;
+    }
+#endif
+    direct = false;
+    return open(file_name.c_str(), O_RDWR);
+}
+
+DirectTape::DirectTape(std::string const& file_name, TapeDelays const& delays,
+                       MemoryBudget* budget, size_t const block_bytes)
+    : delays_(delays),
+      budget_(budget),
+      block_bytes_(std::max(kAlignment, block_bytes / kAlignment * kAlignment)) {
+    if (budget_ != nullptr) {
+        while (block_bytes_ > kAlignment &&
+               block_bytes_ > budget_->Available() / kTapeBudgetShare) {
+            block_bytes_ = std::max(kAlignment, block_bytes_ / 2 / kAlignment * kAlignment);
+        }
+        if (!budget_->TryReserve(block_bytes_)) {
+            throw MemoryBudgetExceeded("Memory budget is too small for a direct I/O tape");
+        }
+    }
+
+    fd_ = OpenUncached(file_name, direct_);
+    if (fd_ < 0) {
+        if (budget_ != nullptr) {
+            budget_->Release(block_bytes_);
+        }
+        throw std::runtime_error("Failed to open file: " + file_name);
+    }
+    try {
+        buffer_ = static_cast<char*>(::operator new(block_bytes_, std::align_val_t(kAlignment)));
+    } catch (...) {
+        close(fd_);
+        if (budget_ != nullptr) {
+            budget_->Release(block_bytes_);
+        }
+        throw;
+    }
+#ifdef F_NOCACHE
+    direct_ = direct_ || fcntl(fd_, F_NOCACHE, 1) == 0;
+#endif
+#ifdef POSIX_FADV_SEQUENTIAL
+    if (!direct_) {
+        posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+
+    size_ = static_cast<size_t>(lseek(fd_, 0, SEEK_END));
+}
+
+DirectTape::~DirectTape() {
+    try {
+        Flush();
+    } catch (std::exception const& e) {
+        std::cerr << "Error flushing direct I/O tape: " << e.what() << std::endl;
+    }
+    close(fd_);
+    ::operator delete(buffer_, std::align_val_t(kAlignment));
+    if (budget_ != nullptr) {
+        budget_->Release(block_bytes_);
+    }
+}
+
+bool DirectTape::Read(int32_t& value) {
+    std::this_thread::sleep_for(delays_.read_delay_ms_);
+    if (position_ + sizeof(value) > size_) {
+        return false;
+    }
+
+    Load(position_ / block_bytes_);
+    std::memcpy(&value, buffer_ + position_ % block_bytes_, sizeof(value));
+    return true;
+}
+
+void DirectTape::Write(int32_t const value) {
+    std::this_thread::sleep_for(delays_.write_delay_ms_);
+    Load(position_ / block_bytes_);
+    std::memcpy(buffer_ + position_ % block_bytes_, &value, sizeof(value));
+    dirty_ = true;
+    size_ = std::max(size_, position_ + sizeof(value));
+}
+
+void DirectTape::Move(MoveDirection const direction) {
+    std::this_thread::sleep_for(delays_.move_delay_ms_);
+    if (direction == MoveDirection::kForward) {
+        position_ += sizeof(int32_t);
+    } else if (position_ >= sizeof(int32_t)) {
+        position_ -= sizeof(int32_t);
+    } else {
+        throw std::out_of_range("New position is out of bounds");
+    }
+}
+
+void DirectTape::Rewind() {
+    std::this_thread::sleep_for(delays_.rewind_delay_ms_);
+    position_ = 0;
+}
+
+void DirectTape::Flush() {
+    WriteBack();
+    if (direct_ && ftruncate(fd_, static_cast<off_t>(size_)) != 0) {
+        throw IoError("Failed to trim direct I/O tape");
+    }
+}
+
+void DirectTape::Load(size_t const block) {
+    if (block == block_) {
+        return;
+    }
+    if (block_ != kNoBlock) {
+        WriteBack();
+        DropCached(block_);
+    }
+
+    size_t const offset = block * block_bytes_;
+    size_t loaded = 0;
+    while (offset + loaded < size_ && loaded < block_bytes_) {
+        ssize_t const bytes = pread(fd_, buffer_ + loaded, block_bytes_ - loaded,
+                                    static_cast<off_t>(offset + loaded));
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw IoError("Failed to read direct I/O tape");
+        }
+        if (bytes == 0) {
+            break;
+        }
+        loaded += static_cast<size_t>(bytes);
+    }
+    std::memset(buffer_ + loaded, 0, block_bytes_ - loaded);
+    block_ = block;
+}
+
+void DirectTape::WriteBack() {
+    if (!dirty_) {
+        return;
+    }
+
+    // O_DIRECT transfers whole aligned blocks, so the padding past the end is trimmed by Flush.
+    size_t const offset = block_ * block_bytes_;
+    size_t const length = direct_ ? block_bytes_ : std::min(block_bytes_, size_ - offset);
+    size_t written = 0;
+    while (written < length) {
+        ssize_t const bytes = pwrite(fd_, buffer_ + written, length - written,
+                                     static_cast<off_t>(offset + written));
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw IoError("Failed to write direct I/O tape");
+        }
+        written += static_cast<size_t>(bytes);
+    }
+    dirty_ = false;
+}
+
+void DirectTape::DropCached(size_t const block) const {
+#ifdef POSIX_FADV_DONTNEED
+    if (!direct_) {
+        posix_fadvise(fd_, static_cast<off_t>(block * block_bytes_),
+                      static_cast<off_t>(block_bytes_), POSIX_FADV_DONTNEED);
+    }
+#else
+    static_cast<void>(block);
+#endif
+}
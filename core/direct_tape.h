@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+#include "i_tape.h"
+#include "memory_budget.h"
+#include "tape_config.h"
+
+// Opens a file for reading and writing with O_DIRECT, or without it where the file system does
+// not support it. Returns -1 on failure.
+int OpenUncached(std::string const& file_name, bool& direct);
+
+// Tape over a file that bypasses the page cache. The file is opened with O_DIRECT and accessed
+// in large aligned blocks through a single block buffer. Where O_DIRECT is not supported, the
+// file is read and written through the cache with posix_fadvise hints to drop every block once
+// the head leaves it.
+class DirectTape : public ITape {
+public:
+    static constexpr size_t kAlignment = 4096;
+    static constexpr size_t kDefaultBlockBytes = size_t{1} << 20;
+
+    // With a budget, the block buffer is drawn from it, halving the block down to kAlignment
+    // bytes until it takes at most 1/kTapeBudgetShare of the available budget.
+    DirectTape(std::string const& file_name, TapeDelays const& delays,
+               MemoryBudget* budget = nullptr, size_t block_bytes = kDefaultBlockBytes);
+    ~DirectTape() override;
+
+    DirectTape(DirectTape const&) = delete;
+    DirectTape& operator=(DirectTape const&) = delete;
+
+    bool Read(int32_t& value) override;
+    void Write(int32_t value) override;
+    void Move(MoveDirection direction) override;
+    void Rewind() override;
+
+    // Writes the buffered block and trims the block padding off the file.
+    void Flush();
+
+    [[nodiscard]] bool IsDirect() const {
+        return direct_;
+    }
+
+private:
+    static constexpr size_t kNoBlock = static_cast<size_t>(-1);
+
+    int fd_ = -1;
+    bool direct_ = false;
+    TapeDelays delays_;
+    MemoryBudget* budget_;
+    size_t block_bytes_;
+    char* buffer_ = nullptr;
+
+    size_t position_ = 0;
+    size_t size_ = 0;
+    size_t block_ = kNoBlock;
+    bool dirty_ = false;
+
+    void Load(size_t block);
+    void WriteBack();
+    void DropCached(size_t block) const;
+};
@@ -0,0 +1,31 @@
+#include "event_loop.h"
+
+#include <thread>
+
+void EventLoop::Schedule(std::coroutine_handle<> handle) {
+    ready_.push_back(handle);
+}
+
+void EventLoop::ScheduleAt(Clock::time_point deadline, std::coroutine_handle<> handle) {
+    timers_.push({deadline, next_sequence_++, handle});
+}
+
+void EventLoop::RunUntilIdle() {
+    while (!ready_.empty() || !timers_.empty()) {
+        if (ready_.empty()) {
+            std::this_thread::sleep_until(timers_.top().deadline);
+        }
+
+        auto const now = Clock::now();
+        while (!timers_.empty() && timers_.top().deadline <= now) {
+            ready_.push_back(timers_.top().handle);
+            timers_.pop();
+        }
+
+        while (!ready_.empty()) {
+            auto handle = ready_.front();
+            ready_.pop_front();
+            handle.resume();
+        }
+    }
+}
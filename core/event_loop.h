@@ -0,0 +1,67 @@
+#pragma once
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <queue>
+#include <vector>
+
+#include "task.h"
+
+// Single-threaded scheduler for coroutines. Tape delays are modeled as timers, so one thread can
+// keep many simulated tapes busy at the same time.
+class EventLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    class SleepAwaiter {
+    public:
+        SleepAwaiter(EventLoop& loop, Clock::duration delay) : loop_(loop), delay_(delay) {}
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return delay_ <= Clock::duration::zero();
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            loop_.ScheduleAt(Clock::now() + delay_, handle);
+        }
+
+        static void await_resume() noexcept {}
+
+    private:
+        EventLoop& loop_;
+        Clock::duration delay_;
+    };
+
+    void Schedule(std::coroutine_handle<> handle);
+    void ScheduleAt(Clock::time_point deadline, std::coroutine_handle<> handle);
+
+    SleepAwaiter Sleep(Clock::duration delay) {
+        return {*this, delay};
+    }
+
+    template <typename T>
+    T Run(Task<T> task) {
+        Schedule(task.GetHandle());
+        RunUntilIdle();
+        return task.Result();
+    }
+
+    void RunUntilIdle();
+
+private:
+    struct Timer {
+        Clock::time_point deadline;
+        uint64_t sequence;
+        std::coroutine_handle<> handle;
+
+        bool operator>(Timer const& other) const {
+            return deadline != other.deadline ? deadline > other.deadline
+                                              : sequence > other.sequence;
+        }
+    };
+
+    std::deque<std::coroutine_handle<>> ready_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;
+    uint64_t next_sequence_ = 0;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <chrono>
+#include <concepts>
 #include <cstdint>
 
 enum class MoveDirection { kForward, kBackward };
@@ -13,3 +14,13 @@ public:
     virtual void Move(MoveDirection direction) = 0;
     virtual void Rewind() = 0;
 };
+
+// The tape operations the sorter loops are written against. ITape and the concrete tapes satisfy
+// it, as do the non-virtual accessors of tape_dispatch.h.
+template <typename T>
+concept SequentialTape = requires(T& tape, int32_t& value, MoveDirection direction) {
+    { tape.Read(value) } -> std::same_as<bool>;
+    tape.Write(value);
+    tape.Move(direction);
+    tape.Rewind();
+};
@@ -0,0 +1,352 @@
+#include "io_engine.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <iterator>
+#include <system_error>
+
+#ifdef TAPE_SORTER_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#endif
+
+namespace {
+std::system_error IoError(int const error, char const* what) {
+    return {error, std::generic_category(), what};
+}
+}  // namespace
+
+std::unique_ptr<IoEngine> IoEngine::Create(unsigned const queue_depth) {
+#ifdef TAPE_SORTER_HAS_IO_URING
+    try {
+        return std::make_unique<UringIoEngine>(queue_depth);
+    } catch (std::system_error const&) {
+        // io_uring is missing or disabled, e.g. by a seccomp filter.
+    }
+#endif
+    return std::make_unique<ThreadPoolIoEngine>();
+}
+
+ThreadPoolIoEngine::ThreadPoolIoEngine(size_t const workers) {
+    for (size_t idx = 0; idx < std::max<size_t>(workers, 1); ++idx) {
+        workers_.emplace_back(&ThreadPoolIoEngine::Work, this);
+    }
+}
+
+ThreadPoolIoEngine::~ThreadPoolIoEngine() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+        std::move(queued_.begin(), queued_.end(), std::back_inserter(submitted_));
+        queued_.clear();
+    }
+    ready_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::future<size_t> ThreadPoolIoEngine::Enqueue(std::function<size_t()> operation) {
+    std::packaged_task<size_t()> task(std::move(operation));
+    auto future = task.get_future();
+    std::lock_guard lock(mutex_);
+    queued_.push_back(std::move(task));
+    return future;
+}
+
+std::future<size_t> ThreadPoolIoEngine::Read(int const fd, void* buffer, size_t const length,
+                                             uint64_t const offset) {
+    return Enqueue([fd, buffer, length, offset] {
+        ssize_t bytes;
+        do {
+            bytes = pread(fd, buffer, length, static_cast<off_t>(offset));
+        } while (bytes < 0 && errno == EINTR);
+        if (bytes < 0) {
+            throw IoError(errno, "Asynchronous tape read failed");
+        }
+        return static_cast<size_t>(bytes);
+    });
+}
+
+std::future<size_t> ThreadPoolIoEngine::Write(int const fd, void const* buffer,
+                                              size_t const length, uint64_t const offset) {
+    return Enqueue([fd, buffer, length, offset] {
+        ssize_t bytes;
+        do {
+            bytes = pwrite(fd, buffer, length, static_cast<off_t>(offset));
+        } while (bytes < 0 && errno == EINTR);
+        if (bytes < 0) {
+            throw IoError(errno, "Asynchronous tape write failed");
+        }
+        return static_cast<size_t>(bytes);
+    });
+}
+
+void ThreadPoolIoEngine::Submit() {
+    {
+        std::lock_guard lock(mutex_);
+        if (queued_.empty()) {
+            return;
+        }
+        std::move(queued_.begin(), queued_.end(), std::back_inserter(submitted_));
+        queued_.clear();
+    }
+    ready_.notify_all();
+}
+
+void ThreadPoolIoEngine::Work() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        ready_.wait(lock, [this] { return stop_ || !submitted_.empty(); });
+        if (submitted_.empty()) {
+            return;
+        }
+        auto task = std::move(submitted_.front());
+        submitted_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+#ifdef TAPE_SORTER_HAS_IO_URING
+namespace {
+int IoUringSetup(unsigned const entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int const fd, unsigned const to_submit, unsigned const min_complete,
+                 unsigned const flags) {
+    return static_cast<int>(
+            syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+// user_data of the no-op that stops the reaper.
+constexpr uint64_t kStopRequest = 0;
+}  // namespace
+
+struct UringIoEngine::Request {
+    iovec iov;
+    std::promise<size_t> promise;
+};
+
+struct UringIoEngine::Ring {
+    int fd = -1;
+    unsigned sq_entries = 0;
+    unsigned cq_entries = 0;
+
+    void* sq_ring = MAP_FAILED;
+    size_t sq_ring_size = 0;
+    void* cq_ring = MAP_FAILED;
+    size_t cq_ring_size = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqes_size = 0;
+
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned sq_mask = 0;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    // Requests placed in the submission queue but not yet handed to the kernel.
+    unsigned unsubmitted = 0;
+    std::atomic<unsigned> in_flight = 0;
+
+    explicit Ring(unsigned const depth) {
+        io_uring_params params{};
+        fd = IoUringSetup(depth, &params);
+        if (fd < 0) {
+            throw IoError(errno, "Failed to set up io_uring");
+        }
+        sq_entries = params.sq_entries;
+        cq_entries = params.cq_entries;
+
+        sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool const single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+        }
+
+        try {
+            sq_ring = Map(sq_ring_size, IORING_OFF_SQ_RING);
+            cq_ring = single_mmap ? sq_ring : Map(cq_ring_size, IORING_OFF_CQ_RING);
+            sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(Map(sqes_size, IORING_OFF_SQES));
+        } catch (...) {
+            Release();
+            throw;
+        }
+
+        auto* sq = static_cast<char*>(sq_ring);
+        sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto* cq = static_cast<char*>(cq_ring);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    ~Ring() {
+        Release();
+    }
+
+    Ring(Ring const&) = delete;
+    Ring& operator=(Ring const&) = delete;
+
+    void Release() const {
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, sqes_size);
+        }
+        if (cq_ring != MAP_FAILED && cq_ring != sq_ring) {
+            munmap(cq_ring, cq_ring_size);
+        }
+        if (sq_ring != MAP_FAILED) {
+            munmap(sq_ring, sq_ring_size);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    void* Map(size_t const size, off_t const offset) const {
+        void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                             offset);
+        if (address == MAP_FAILED) {
+            throw IoError(errno, "Failed to map io_uring");
+        }
+        return address;
+    }
+
+    [[nodiscard]] bool SubmissionQueueFull() const {
+        unsigned const head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+        return *sq_tail - head == sq_entries;
+    }
+
+    void Push(io_uring_sqe const& entry) {
+        unsigned const tail = *sq_tail;
+        unsigned const index = tail & sq_mask;
+        sqes[index] = entry;
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        ++unsubmitted;
+    }
+};
+
+UringIoEngine::UringIoEngine(unsigned const queue_depth)
+    : ring_(std::make_unique<Ring>(queue_depth)), reaper_(&UringIoEngine::Reap, this) {}
+
+UringIoEngine::~UringIoEngine() {
+    {
+        std::lock_guard lock(submit_mutex_);
+        while (ring_->SubmissionQueueFull()) {
+            SubmitLocked();
+        }
+        io_uring_sqe stop{};
+        stop.opcode = IORING_OP_NOP;
+        stop.user_data = kStopRequest;
+        ring_->Push(stop);
+        SubmitLocked();
+    }
+    reaper_.join();
+}
+
+std::future<size_t> UringIoEngine::Enqueue(uint8_t const opcode, int const fd, void* buffer,
+                                           size_t const length, uint64_t const offset) {
+    std::lock_guard lock(submit_mutex_);
+    // Keep completions within the completion queue, which the reaper drains.
+    while (ring_->in_flight.load() >= ring_->cq_entries || ring_->SubmissionQueueFull()) {
+        SubmitLocked();
+        std::this_thread::yield();
+    }
+
+    auto request = std::make_unique<Request>();
+    request->iov = {buffer, length};
+    auto future = request->promise.get_future();
+
+    io_uring_sqe entry{};
+    entry.opcode = opcode;
+    entry.fd = fd;
+    entry.addr = reinterpret_cast<uint64_t>(&request->iov);
+    entry.len = 1;
+    entry.off = offset;
+    entry.user_data = reinterpret_cast<uint64_t>(request.get());
+    ring_->Push(entry);
+    ++ring_->in_flight;
+    request.release();
+    return future;
+}
+
+std::future<size_t> UringIoEngine::Read(int const fd, void* buffer, size_t const length,
+                                        uint64_t const offset) {
+    return Enqueue(IORING_OP_READV, fd, buffer, length, offset);
+}
+
+std::future<size_t> UringIoEngine::Write(int const fd, void const* buffer, size_t const length,
+                                         uint64_t const offset) {
+    return Enqueue(IORING_OP_WRITEV, fd, const_cast<void*>(buffer), length, offset);
+}
+
+void UringIoEngine::Submit() {
+    std::lock_guard lock(submit_mutex_);
+    SubmitLocked();
+}
+
+void UringIoEngine::SubmitLocked() {
+    while (ring_->unsubmitted > 0) {
+        int const submitted = IoUringEnter(ring_->fd, ring_->unsubmitted, 0, 0);
+        if (submitted < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                std::this_thread::yield();
+                continue;
+            }
+            throw IoError(errno, "Failed to submit to io_uring");
+        }
+        ring_->unsubmitted -= static_cast<unsigned>(submitted);
+    }
+}
+
+void UringIoEngine::Reap() {
+    bool stopping = false;
+    while (!stopping || ring_->in_flight.load() > 0) {
+        if (IoUringEnter(ring_->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR &&
+            errno != EAGAIN && errno != EBUSY) {
+            // Completions can no longer be collected, so the futures would never be ready.
+            std::terminate();
+        }
+
+        unsigned head = *ring_->cq_head;
+        unsigned const tail = __atomic_load_n(ring_->cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            io_uring_cqe const& completion = ring_->cqes[head & ring_->cq_mask];
+            if (completion.user_data == kStopRequest) {
+                stopping = true;
+                continue;
+            }
+
+            std::unique_ptr<Request> request(reinterpret_cast<Request*>(completion.user_data));
+            if (completion.res < 0) {
+                request->promise.set_exception(std::make_exception_ptr(
+                        IoError(-completion.res, "Asynchronous tape I/O failed")));
+            } else {
+                request->promise.set_value(static_cast<size_t>(completion.res));
+            }
+            --ring_->in_flight;
+        }
+        __atomic_store_n(ring_->cq_head, head, __ATOMIC_RELEASE);
+    }
+}
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Asynchronous positional file I/O. Requests are queued and handed over in batches by Submit,
+// so readahead and write-behind of many tapes can be issued with a single system call. The
+// buffer of a request must stay alive until its future is ready. A failed request rethrows its
+// error from the future.
+class IoEngine {
+public:
+    static constexpr unsigned kDefaultQueueDepth = 256;
+
+    virtual ~IoEngine() = default;
+
+    virtual std::future<size_t> Read(int fd, void* buffer, size_t length, uint64_t offset) = 0;
+    virtual std::future<size_t> Write(int fd, void const* buffer, size_t length,
+                                      uint64_t offset) = 0;
+    virtual void Submit() = 0;
+
+    [[nodiscard]] virtual char const* Name() const = 0;
+
+    // io_uring where the kernel allows it, a thread pool otherwise.
+    static std::unique_ptr<IoEngine> Create(unsigned queue_depth = kDefaultQueueDepth);
+};
+
+// Runs pread and pwrite on a pool of worker threads.
+class ThreadPoolIoEngine : public IoEngine {
+public:
+    explicit ThreadPoolIoEngine(size_t workers = 4);
+    ~ThreadPoolIoEngine() override;
+
+    std::future<size_t> Read(int fd, void* buffer, size_t length, uint64_t offset) override;
+    std::future<size_t> Write(int fd, void const* buffer, size_t length,
+                              uint64_t offset) override;
+    void Submit() override;
+
+    [[nodiscard]] char const* Name() const override {
+        return "thread pool";
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::packaged_task<size_t()>> queued_;
+    std::deque<std::packaged_task<size_t()>> submitted_;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+
+    std::future<size_t> Enqueue(std::function<size_t()> operation);
+    void Work();
+};
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define TAPE_SORTER_HAS_IO_URING
+
+// io_uring driven through raw system calls. A reaper thread waits for completions and fulfils
+// the futures of finished requests.
+class UringIoEngine : public IoEngine {
+public:
+    // Throws std::system_error if the kernel refuses to set up a ring.
+    explicit UringIoEngine(unsigned queue_depth = kDefaultQueueDepth);
+    ~UringIoEngine() override;
+
+    std::future<size_t> Read(int fd, void* buffer, size_t length, uint64_t offset) override;
+    std::future<size_t> Write(int fd, void const* buffer, size_t length,
+                              uint64_t offset) override;
+    void Submit() override;
+
+    [[nodiscard]] char const* Name() const override {
+        return "io_uring";
+    }
+
+private:
+    struct Ring;
+    struct Request;
+
+    std::unique_ptr<Ring> ring_;
+    std::mutex submit_mutex_;
+    std::thread reaper_;
+
+    std::future<size_t> Enqueue(uint8_t opcode, int fd, void* buffer, size_t length,
+                                uint64_t offset);
+    void SubmitLocked();
+    void Reap();
+};
+#endif
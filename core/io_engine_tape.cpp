@@ -0,0 +1,218 @@
+#include "io_engine_tape.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include "direct_tape.h"
+
+IoEngineTape::IoEngineTape(std::string const& file_name, TapeDelays const& delays,
+                           std::shared_ptr<IoEngine> engine, MemoryBudget* budget,
+                           size_t const block_bytes)
+    : delays_(delays),
+      engine_(std::move(engine)),
+      budget_(budget),
+      block_bytes_(std::max(kAlignment, block_bytes / kAlignment * kAlignment)) {
+    if (budget_ != nullptr) {
+        while (block_bytes_ > kAlignment &&
+               kSlots * block_bytes_ > budget_->Available() / kTapeBudgetShare) {
+            block_bytes_ = std::max(kAlignment, block_bytes_ / 2 / kAlignment * kAlignment);
+        }
+        if (!budget_->TryReserve(kSlots * block_bytes_)) {
+            throw MemoryBudgetExceeded("Memory budget is too small for an I/O engine tape");
+        }
+    }
+
+    fd_ = OpenUncached(file_name, direct_);
+    if (fd_ < 0) {
+        if (budget_ != nullptr) {
+            budget_->Release(kSlots * block_bytes_);
+        }
+        throw std::runtime_error("Failed to open file: " + file_name);
+    }
+    try {
+        for (auto& slot : slots_) {
+            slot.data =
+                    static_cast<char*>(::operator new(block_bytes_, std::align_val_t(kAlignment)));
+        }
+    } catch (...) {
+        for (auto& slot : slots_) {
+            ::operator delete(slot.data, std::align_val_t(kAlignment));
+        }
+        close(fd_);
+        if (budget_ != nullptr) {
+            budget_->Release(kSlots * block_bytes_);
+        }
+        throw;
+    }
+
+    size_ = static_cast<size_t>(lseek(fd_, 0, SEEK_END));
+}
+
+IoEngineTape::~IoEngineTape() {
+    try {
+        Flush();
+    } catch (std::exception const& e) {
+        std::cerr << "Error flushing I/O engine tape: " << e.what() << std::endl;
+    }
+    for (auto& slot : slots_) {
+        if (slot.pending.valid()) {
+            slot.pending.wait();
+        }
+        ::operator delete(slot.data, std::align_val_t(kAlignment));
+    }
+    close(fd_);
+    if (budget_ != nullptr) {
+        budget_->Release(kSlots * block_bytes_);
+    }
+}
+
+bool IoEngineTape::Read(int32_t& value) {
+    std::this_thread::sleep_for(delays_.read_delay_ms_);
+    if (position_ + sizeof(value) > size_) {
+        return false;
+    }
+
+    Slot const& slot = Access(position_ / block_bytes_);
+    std::memcpy(&value, slot.data + position_ % block_bytes_, sizeof(value));
+    return true;
+}
+
+void IoEngineTape::Write(int32_t const value) {
+    std::this_thread::sleep_for(delays_.write_delay_ms_);
+    Slot& slot = Access(position_ / block_bytes_);
+    std::memcpy(slot.data + position_ % block_bytes_, &value, sizeof(value));
+    slot.dirty = true;
+    size_ = std::max(size_, position_ + sizeof(value));
+}
+
+void IoEngineTape::Move(MoveDirection const direction) {
+    std::this_thread::sleep_for(delays_.move_delay_ms_);
+    if (direction == MoveDirection::kForward) {
+        position_ += sizeof(int32_t);
+    } else if (position_ >= sizeof(int32_t)) {
+        position_ -= sizeof(int32_t);
+    } else {
+        throw std::out_of_range("New position is out of bounds");
+    }
+}
+
+void IoEngineTape::Rewind() {
+    std::this_thread::sleep_for(delays_.rewind_delay_ms_);
+    position_ = 0;
+}
+
+void IoEngineTape::Flush() {
+    for (auto& slot : slots_) {
+        WriteBack(slot);
+    }
+    engine_->Submit();
+    for (auto& slot : slots_) {
+        Wait(slot);
+    }
+    if (direct_ && ftruncate(fd_, static_cast<off_t>(size_)) != 0) {
+        throw std::runtime_error(std::string("Failed to trim I/O engine tape: ") +
+                                 std::strerror(errno));
+    }
+}
+
+IoEngineTape::Slot& IoEngineTape::Access(size_t const block) {
+    if (current_ != nullptr && current_->block == block) {
+        return *current_;
+    }
+
+    bool forward = true;
+    if (current_ != nullptr) {
+        forward = block > current_->block;
+        WriteBack(*current_);
+    }
+
+    Slot* slot = Find(block);
+    if (slot == nullptr) {
+        slot = &Victim();
+        Fill(*slot, block);
+    }
+    current_ = slot;
+    current_->last_use = ++uses_;
+
+    size_t const next = forward ? block + 1 : block - 1;
+    if ((forward || block > 0) && next * block_bytes_ < size_ && Find(next) == nullptr) {
+        Slot& ahead = Victim();
+        Fill(ahead, next);
+        ahead.last_use = ++uses_;
+    }
+    engine_->Submit();
+
+    Wait(*current_);
+    return *current_;
+}
+
+IoEngineTape::Slot* IoEngineTape::Find(size_t const block) {
+    for (auto& slot : slots_) {
+        if (slot.block == block) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+IoEngineTape::Slot& IoEngineTape::Victim() {
+    Slot* victim = nullptr;
+    for (auto& slot : slots_) {
+        if (&slot != current_ && (victim == nullptr || slot.last_use < victim->last_use)) {
+            victim = &slot;
+        }
+    }
+    return *victim;
+}
+
+void IoEngineTape::Fill(Slot& slot, size_t const block) {
+    Wait(slot);
+    WriteBack(slot);
+    Wait(slot);
+
+    slot.block = block;
+    size_t const offset = block * block_bytes_;
+    if (offset < size_) {
+        slot.reading = true;
+        slot.expected = block_bytes_;
+        slot.pending = engine_->Read(fd_, slot.data, block_bytes_, offset);
+    } else {
+        std::memset(slot.data, 0, block_bytes_);
+    }
+}
+
+void IoEngineTape::WriteBack(Slot& slot) {
+    if (!slot.dirty) {
+        return;
+    }
+    Wait(slot);
+
+    // O_DIRECT transfers whole aligned blocks, so the padding past the end is trimmed by Flush.
+    size_t const offset = slot.block * block_bytes_;
+    slot.expected = direct_ ? block_bytes_ : std::min(block_bytes_, size_ - offset);
+    slot.reading = false;
+    slot.pending = engine_->Write(fd_, slot.data, slot.expected, offset);
+    slot.dirty = false;
+}
+
+void IoEngineTape::Wait(Slot& slot) {
+    if (!slot.pending.valid()) {
+        return;
+    }
+    engine_->Submit();
+    size_t const transferred = slot.pending.get();
+    if (slot.reading) {
+        std::memset(slot.data + transferred, 0, block_bytes_ - transferred);
+        slot.reading = false;
+    } else if (transferred != slot.expected) {
+        throw std::runtime_error("Short write to I/O engine tape");
+    }
+}
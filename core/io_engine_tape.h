@@ -0,0 +1,73 @@
+#pragma once
+#include <array>
+#include <future>
+#include <memory>
+#include <string>
+
+#include "i_tape.h"
+#include "io_engine.h"
+#include "memory_budget.h"
+#include "tape_config.h"
+
+// Tape over a file whose blocks are transferred by an IoEngine. Once the head enters a block, the
+// block left behind is written back and the next block in the direction of travel is read ahead
+// asynchronously, so many tapes sharing an engine keep its queue full. The file is opened with
+// O_DIRECT where supported.
+class IoEngineTape : public ITape {
+public:
+    static constexpr size_t kAlignment = 4096;
+    static constexpr size_t kDefaultBlockBytes = size_t{1} << 20;
+    // The block under the head, the one read ahead and the one being written back.
+    static constexpr size_t kSlots = 3;
+
+    // With a budget, the block buffers are drawn from it, halving the block down to kAlignment
+    // bytes until they take at most 1/kTapeBudgetShare of the available budget.
+    IoEngineTape(std::string const& file_name, TapeDelays const& delays,
+                 std::shared_ptr<IoEngine> engine, MemoryBudget* budget = nullptr,
+                 size_t block_bytes = kDefaultBlockBytes);
+    ~IoEngineTape() override;
+
+    IoEngineTape(IoEngineTape const&) = delete;
+    IoEngineTape& operator=(IoEngineTape const&) = delete;
+
+    bool Read(int32_t& value) override;
+    void Write(int32_t value) override;
+    void Move(MoveDirection direction) override;
+    void Rewind() override;
+
+    // Waits for all transfers and trims the block padding off the file.
+    void Flush();
+
+private:
+    static constexpr size_t kNoBlock = static_cast<size_t>(-1);
+
+    struct Slot {
+        char* data = nullptr;
+        size_t block = kNoBlock;
+        size_t last_use = 0;
+        bool dirty = false;
+        bool reading = false;
+        size_t expected = 0;
+        std::future<size_t> pending;
+    };
+
+    int fd_ = -1;
+    bool direct_ = false;
+    TapeDelays delays_;
+    std::shared_ptr<IoEngine> engine_;
+    MemoryBudget* budget_;
+    size_t block_bytes_;
+    std::array<Slot, kSlots> slots_;
+
+    size_t position_ = 0;
+    size_t size_ = 0;
+    Slot* current_ = nullptr;
+    size_t uses_ = 0;
+
+    Slot& Access(size_t block);
+    Slot* Find(size_t block);
+    Slot& Victim();
+    void Fill(Slot& slot, size_t block);
+    void WriteBack(Slot& slot);
+    void Wait(Slot& slot);
+};
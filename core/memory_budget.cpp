@@ -0,0 +1,33 @@
+#include "memory_budget.h"
+
+void MemoryBudget::Reserve(size_t const bytes) {
+    if (!TryReserve(bytes)) {
+        throw MemoryBudgetExceeded("Memory budget exceeded: requested " + std::to_string(bytes) +
+                                   " bytes with " + std::to_string(Available()) + " of " +
+                                   std::to_string(limit_) + " available");
+    }
+}
+
+bool MemoryBudget::TryReserve(size_t const bytes) noexcept {
+    size_t used = used_.load(std::memory_order_relaxed);
+    do {
+        if (bytes > limit_ - used) {
+            return false;
+        }
+    } while (!used_.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+
+    size_t const now = used + bytes;
+    size_t peak = peak_.load(std::memory_order_relaxed);
+    while (now > peak && !peak_.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+void MemoryBudget::Release(size_t const bytes) noexcept {
+    used_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+size_t MemoryBudget::Available() const noexcept {
+    size_t const used = Used();
+    return used < limit_ ? limit_ - used : 0;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+class MemoryBudgetExceeded : public std::bad_alloc {
+public:
+    explicit MemoryBudgetExceeded(std::string message) : message_(std::move(message)) {}
+
+    [[nodiscard]] char const* what() const noexcept override {
+        return message_.c_str();
+    }
+
+private:
+    std::string message_;
+};
+
+// Thread-safe byte accounting shared by all sorter components.
+class MemoryBudget {
+public:
+    explicit MemoryBudget(size_t limit_bytes) : limit_(limit_bytes) {}
+
+    void Reserve(size_t bytes);
+    bool TryReserve(size_t bytes) noexcept;
+    void Release(size_t bytes) noexcept;
+
+    [[nodiscard]] size_t Limit() const noexcept {
+        return limit_;
+    }
+
+    [[nodiscard]] size_t Used() const noexcept {
+        return used_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t Peak() const noexcept {
+        return peak_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t Available() const noexcept;
+
+private:
+    size_t limit_;
+    std::atomic<size_t> used_ = 0;
+    std::atomic<size_t> peak_ = 0;
+};
+
+// Block tapes take at most this fraction (1/kTapeBudgetShare) of the available budget for their
+// buffers. Runs hold their tapes until merged, so one tape leaves room for the tapes that follow.
+inline constexpr size_t kTapeBudgetShare = 4;
+
+// Standard allocator drawing from a MemoryBudget. A null budget allocates without accounting.
+template <typename T>
+class BudgetAllocator {
+public:
+    using value_type = T;
+
+    BudgetAllocator() noexcept = default;
+
+    explicit BudgetAllocator(MemoryBudget* budget) noexcept : budget_(budget) {}
+
+    template <typename U>
+    BudgetAllocator(BudgetAllocator<U> const& other) noexcept : budget_(other.Budget()) {}
+
+    T* allocate(size_t n) {
+        if (budget_ != nullptr) {
+            budget_->Reserve(n * sizeof(T));
+        }
+        try {
+            return std::allocator<T>().allocate(n);
+        } catch (...) {
+            if (budget_ != nullptr) {
+                budget_->Release(n * sizeof(T));
+            }
+            throw;
+        }
+    }
+
+    void deallocate(T* pointer, size_t n) noexcept {
+        std::allocator<T>().deallocate(pointer, n);
+        if (budget_ != nullptr) {
+            budget_->Release(n * sizeof(T));
+        }
+    }
+
+    [[nodiscard]] MemoryBudget* Budget() const noexcept {
+        return budget_;
+    }
+
+    template <typename U>
+    bool operator==(BudgetAllocator<U> const& other) const noexcept {
+        return budget_ == other.Budget();
+    }
+
+private:
+    MemoryBudget* budget_ = nullptr;
+};
+
+template <typename T>
+using BudgetVector = std::vector<T, BudgetAllocator<T>>;
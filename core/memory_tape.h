@@ -0,0 +1,58 @@
+#pragma once
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "i_tape.h"
+#include "tmp_tape_factory.h"
+
+class MemoryTape : public ITape {
+public:
+    explicit MemoryTape(std::vector<int32_t> const& initial_data = {})
+        : data_(initial_data), position_(0) {}
+
+    bool Read(int32_t& value) override {
+        if (position_ >= data_.size()) {
+            return false;
+        }
+        value = data_[position_];
+        return true;
+    }
+
+    void Write(int32_t value) override {
+        if (position_ >= data_.size()) {
+            data_.push_back(value);
+        } else {
+            data_[position_] = value;
+        }
+    }
+
+    void Move(MoveDirection direction) override {
+        if (direction == MoveDirection::kForward) {
+            position_++;
+        } else if (position_ > 0) {
+            position_--;
+        } else {
+            throw std::out_of_range("Cannot move backward at position 0");
+        }
+    }
+
+    void Rewind() override {
+        position_ = 0;
+    }
+
+    [[nodiscard]] std::vector<int32_t> const& GetData() const {
+        return data_;
+    }
+
+private:
+    std::vector<int32_t> data_;
+    size_t position_;
+};
+
+class MemoryTapeFactory : public ITapeFactory {
+public:
+    std::unique_ptr<ITape> Create() override {
+        return std::make_unique<MemoryTape>();
+    }
+};
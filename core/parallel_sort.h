@@ -0,0 +1,66 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <system_error>
+#include <thread>
+
+// Below this many elements a range is sorted by std::sort on the calling thread.
+inline constexpr size_t kParallelSortMinElements = size_t{1} << 16;
+
+// Sorts [first, last) in place with up to `threads` threads. The range is split around a
+// splitter taken from a sample of its elements into the elements ordered before it, equal to it
+// and after it; the outer parts are sorted concurrently, each with a share of the threads
+// proportional to its size, until every thread sorts its part with std::sort. Unlike a sample
+// sort with a scatter step, no buffer of the range size is needed. Not stable.
+template <std::random_access_iterator Iterator, typename Compare>
+void ParallelSort(Iterator first, Iterator last, Compare compare, size_t const threads,
+                  size_t const min_elements = kParallelSortMinElements) {
+    auto const size = static_cast<size_t>(last - first);
+    if (threads <= 1 || size < std::max<size_t>(min_elements, 2)) {
+        std::sort(first, last, compare);
+        return;
+    }
+
+    using Value = std::iter_value_t<Iterator>;
+    constexpr size_t kSample = 63;
+    std::array<Value, kSample> sample;
+    for (size_t idx = 0; idx < kSample; ++idx) {
+        sample[idx] = first[static_cast<std::ptrdiff_t>(idx * (size - 1) / (kSample - 1))];
+    }
+    auto const median = sample.begin() + kSample / 2;
+    std::nth_element(sample.begin(), median, sample.end(), compare);
+    Value const splitter = *median;
+
+    Iterator const equal = std::partition(
+            first, last, [&](Value const& value) { return compare(value, splitter); });
+    Iterator const greater = std::partition(
+            equal, last, [&](Value const& value) { return !compare(splitter, value); });
+
+    auto const less_size = static_cast<size_t>(equal - first);
+    auto const greater_size = static_cast<size_t>(last - greater);
+    size_t const less_threads = std::clamp<size_t>(
+            (threads * less_size + (less_size + greater_size) / 2) /
+                    std::max<size_t>(less_size + greater_size, 1),
+            1, threads - 1);
+
+    std::thread worker;
+    try {
+        worker = std::thread(
+                [=] { ParallelSort(first, equal, compare, less_threads, min_elements); });
+    } catch (std::system_error const&) {
+        std::sort(first, equal, compare);
+    }
+    try {
+        ParallelSort(greater, last, compare, threads - less_threads, min_elements);
+    } catch (...) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+        throw;
+    }
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
@@ -0,0 +1,188 @@
+#include "record_sorter.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "run_merger.h"
+
+namespace {
+class RecordReader {
+public:
+    RecordReader(ITape& tape, size_t const length, MoveDirection const direction)
+        : tape_(tape), remaining_(length), direction_(direction) {
+        if (direction_ == MoveDirection::kForward) {
+            tape_.Rewind();
+        }
+    }
+
+    bool Next(Record& record) {
+        if (remaining_ == 0) {
+            return false;
+        }
+        if (direction_ == MoveDirection::kBackward) {
+            record.payload = ReadBackward();
+            record.key = ReadBackward();
+        } else {
+            record.key = ReadForward();
+            record.payload = ReadForward();
+        }
+        --remaining_;
+        return true;
+    }
+
+private:
+    ITape& tape_;
+    size_t remaining_;
+    MoveDirection direction_;
+
+    int32_t ReadForward() {
+        int32_t value;
+        if (!tape_.Read(value)) {
+            throw std::runtime_error("Temporary tape is shorter than its run");
+        }
+        tape_.Move(MoveDirection::kForward);
+        return value;
+    }
+
+    int32_t ReadBackward() {
+        int32_t value;
+        tape_.Move(MoveDirection::kBackward);
+        if (!tape_.Read(value)) {
+            throw std::runtime_error("Temporary tape is shorter than its run");
+        }
+        return value;
+    }
+};
+
+struct HeapElement {
+    Record record;
+    size_t run;
+};
+
+static_assert(sizeof(RecordReader) + sizeof(HeapElement) <= TapeSorter::kMergeBytesPerRun);
+
+void WriteRecord(ITape& tape, Record const& record) {
+    tape.Write(record.key);
+    tape.Move(MoveDirection::kForward);
+    tape.Write(record.payload);
+    tape.Move(MoveDirection::kForward);
+}
+}  // namespace
+
+RunMerger RecordSorter::Merger() const {
+    return {*factory_, options_, TapeSorter::kMergeBytesPerRun};
+}
+
+std::vector<RecordSorter::Run> RecordSorter::Split(ITape& input_tape) const {
+    std::vector<Run> runs;
+    auto const merger = Merger();
+    size_t const block_size = merger.BlockSize(memory_block_, sizeof(Record));
+    bool const descending = merger.StoreRunsDescending(options_.expected_elements, block_size);
+
+    BudgetVector<Record> buffer{BudgetAllocator<Record>(options_.memory_budget)};
+    buffer.reserve(block_size);
+
+    auto* progress = options_.progress;
+    if (progress != nullptr) {
+        progress->StartSplit();
+    }
+
+    Record record;
+    while (input_tape.Read(record.key)) {
+        buffer.clear();
+
+        for (size_t i = 0; i < block_size && input_tape.Read(record.key); ++i) {
+            input_tape.Move(MoveDirection::kForward);
+            if (!input_tape.Read(record.payload)) {
+                throw std::runtime_error("Input tape ends in the middle of a record");
+            }
+            input_tape.Move(MoveDirection::kForward);
+            buffer.push_back(record);
+            if (progress != nullptr) {
+                progress->AddSplit();
+            }
+        }
+
+        std::stable_sort(buffer.begin(), buffer.end(),
+                         [](Record const& lhs, Record const& rhs) { return lhs.key < rhs.key; });
+        if (descending) {
+            std::reverse(buffer.begin(), buffer.end());
+        }
+        auto tmp_tape = factory_->Create();
+        for (auto const& sorted : buffer) {
+            WriteRecord(*tmp_tape, sorted);
+        }
+        runs.push_back({std::move(tmp_tape), buffer.size(), descending});
+        if (progress != nullptr) {
+            progress->AddRun();
+        }
+    }
+
+    return runs;
+}
+
+size_t RecordSorter::MergePass(std::vector<Run>& runs, ITape& output_tape,
+                               bool const ascending) const {
+    // A descending pass emits the reverse of the stable ascending merge, so among equal keys the
+    // later run goes first.
+    auto const compare = [ascending](HeapElement const& lhs, HeapElement const& rhs) {
+        if (lhs.record.key != rhs.record.key) {
+            return ascending ? lhs.record.key > rhs.record.key : lhs.record.key < rhs.record.key;
+        }
+        return ascending ? lhs.run > rhs.run : lhs.run < rhs.run;
+    };
+
+    BudgetVector<HeapElement> heap{BudgetAllocator<HeapElement>(options_.memory_budget)};
+    heap.reserve(runs.size());
+
+    BudgetVector<RecordReader> readers{BudgetAllocator<RecordReader>(options_.memory_budget)};
+    readers.reserve(runs.size());
+    for (size_t idx = 0; idx < runs.size(); ++idx) {
+        bool const backward = options_.strategy == MergeStrategy::kReadBackward &&
+                              runs[idx].descending == ascending;
+        readers.emplace_back(*runs[idx].tape, runs[idx].length,
+                             backward ? MoveDirection::kBackward : MoveDirection::kForward);
+        Record record;
+        if (readers[idx].Next(record)) {
+            heap.push_back({record, idx});
+            std::push_heap(heap.begin(), heap.end(), compare);
+        }
+    }
+
+    auto* progress = options_.progress;
+    size_t written = 0;
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), compare);
+        auto [record, run_idx] = heap.back();
+        heap.pop_back();
+
+        WriteRecord(output_tape, record);
+        ++written;
+        if (progress != nullptr) {
+            progress->AddMerged();
+        }
+
+        if (readers[run_idx].Next(record)) {
+            heap.push_back({record, run_idx});
+            std::push_heap(heap.begin(), heap.end(), compare);
+        }
+    }
+    return written;
+}
+
+void RecordSorter::Sort(ITape& input_tape, ITape& output_tape) const {
+    input_tape.Rewind();
+    auto runs = Split(input_tape);
+    if (!runs.empty()) {
+        output_tape.Rewind();
+        auto const merge_pass = [this](std::vector<Run>& group, ITape& output,
+                                       bool const ascending) {
+            return MergePass(group, output, ascending);
+        };
+        Merger().Merge(runs, output_tape, merge_pass);
+    }
+
+    if (auto* progress = options_.progress; progress != nullptr) {
+        progress->Finish();
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "tape_sorter.h"
+
+// A record occupies two consecutive tape cells: the key followed by the payload.
+struct Record {
+    int32_t key;
+    int32_t payload;
+
+    bool operator==(Record const& other) const = default;
+};
+
+class RunMerger;
+
+// Stable external sort of records by key: records with equal keys keep their input order.
+class RecordSorter {
+public:
+    RecordSorter(size_t const memory_block, std::unique_ptr<ITapeFactory> factory,
+                 SortOptions const& options = {})
+        : memory_block_(memory_block), factory_(std::move(factory)), options_(options) {}
+
+    void Sort(ITape& input_tape, ITape& output_tape) const;
+
+private:
+    // A stably sorted run. A descending run is the exact reverse of the ascending one, so reading
+    // it backward restores input order among equal keys.
+    struct Run {
+        std::unique_ptr<ITape> tape;
+        size_t length;
+        bool descending;
+    };
+
+    size_t memory_block_;
+    std::unique_ptr<ITapeFactory> factory_;
+    SortOptions options_;
+
+    size_t MergePass(std::vector<Run>& runs, ITape& output_tape, bool ascending) const;
+
+    std::vector<Run> Split(ITape& input_tape) const;
+
+    [[nodiscard]] RunMerger Merger() const;
+};
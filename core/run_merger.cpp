@@ -0,0 +1,43 @@
+#include "run_merger.h"
+
+#include <algorithm>
+
+size_t RunMerger::BlockSize(size_t const requested, size_t const element_bytes,
+                            size_t const min_size) const {
+    auto* budget = options_.memory_budget;
+    if (budget == nullptr) {
+        return requested;
+    }
+    size_t const affordable =
+            TapeSorter::MaxBlockSize(budget->Available()) * sizeof(int32_t) / element_bytes;
+    size_t const block_size = std::min(requested, affordable);
+    if (block_size < std::max<size_t>(min_size, 1)) {
+        throw MemoryBudgetExceeded("Memory budget is too small to split the input");
+    }
+    return block_size;
+}
+
+size_t RunMerger::FanIn(size_t const runs) const {
+    size_t fan_in = options_.max_fan_in < 2 ? runs : options_.max_fan_in;
+    if (auto* budget = options_.memory_budget; budget != nullptr) {
+        size_t const affordable = budget->Available() / merge_bytes_per_run_;
+        if (affordable < 2) {
+            throw MemoryBudgetExceeded("Memory budget is too small to merge runs");
+        }
+        fan_in = std::min(fan_in, affordable);
+    }
+    return std::max<size_t>(fan_in, 2);
+}
+
+bool RunMerger::StoreRunsDescending(size_t const expected, size_t const block_size,
+                                    size_t const pinned) const {
+    if (options_.strategy == MergeStrategy::kRewind) {
+        return false;
+    }
+    if (expected == 0) {
+        return true;
+    }
+    size_t const block = std::max<size_t>(block_size, 1);
+    size_t const runs = (expected + block - 1) / block + pinned;
+    return TapeSorter::CountPasses(runs, FanIn(runs), pinned) % 2 == 1;
+}
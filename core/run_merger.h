@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "tape_sorter.h"
+
+// Budget arithmetic and merge passes shared by the sorters. Block sizes count elements of the
+// sorter's own kind, fan-ins count runs that each need merge_bytes_per_run of the budget.
+class RunMerger {
+public:
+    RunMerger(ITapeFactory& factory, SortOptions const& options, size_t const merge_bytes_per_run)
+        : factory_(factory), options_(options), merge_bytes_per_run_(merge_bytes_per_run) {}
+
+    // Elements of element_bytes each held in a split block: requested, shrunk to fit the budget.
+    // Throws MemoryBudgetExceeded if fewer than min_size fit.
+    [[nodiscard]] size_t BlockSize(size_t requested, size_t element_bytes,
+                                   size_t min_size = 1) const;
+
+    [[nodiscard]] size_t FanIn(size_t runs) const;
+
+    // Whether runs are stored descending, so that the final pass reads them backward. Counts the
+    // passes for expected elements split into blocks of block_size, merged with `pinned` runs.
+    [[nodiscard]] bool StoreRunsDescending(size_t expected, size_t block_size,
+                                           size_t pinned = 0) const;
+
+    // Merges runs in passes of at most FanIn() runs until the last pass writes output_tape.
+    // merge_pass(group, output, ascending) merges a group of runs into output and returns the
+    // elements written. The last `pinned` runs are kept out of intermediate passes. A run without
+    // a temp tape is sorted input, read forward.
+    template <typename Run, typename MergePass>
+    void Merge(std::vector<Run>& runs, ITape& output_tape, MergePass const& merge_pass,
+               size_t pinned = 0) const;
+
+private:
+    ITapeFactory& factory_;
+    SortOptions const& options_;
+    size_t merge_bytes_per_run_;
+};
+
+template <typename Run, typename MergePass>
+void RunMerger::Merge(std::vector<Run>& runs, ITape& output_tape, MergePass const& merge_pass,
+                      size_t const pinned) const {
+    auto* progress = options_.progress;
+    if (progress != nullptr) {
+        progress->StartMerge(
+                TapeSorter::CountPasses(runs.size(), FanIn(runs.size()), pinned));
+    }
+
+    for (size_t fan_in = FanIn(runs.size()); runs.size() > fan_in; fan_in = FanIn(runs.size())) {
+        if (progress != nullptr) {
+            progress->StartPass();
+        }
+        size_t const mergeable = runs.size() - pinned;
+        size_t const groups = (mergeable + fan_in - 1) / fan_in;
+        std::vector<Run> merged;
+        merged.reserve(groups + pinned);
+
+        for (size_t group = 0; group < groups; ++group) {
+            size_t const first = group * mergeable / groups;
+            size_t const last = (group + 1) * mergeable / groups;
+            std::vector<Run> group_runs;
+            for (size_t idx = first; idx < last; ++idx) {
+                group_runs.push_back(std::move(runs[idx]));
+            }
+
+            bool const ascending = options_.strategy == MergeStrategy::kRewind ||
+                                   group_runs.front().descending ||
+                                   group_runs.front().tape == nullptr;
+            std::unique_ptr<ITape> tmp_tape;
+            {
+                // The output tape takes its buffer from what the merge structures leave.
+                BudgetVector<std::byte> merge_bytes{
+                        BudgetAllocator<std::byte>(options_.memory_budget)};
+                merge_bytes.reserve(group_runs.size() * merge_bytes_per_run_);
+                tmp_tape = factory_.Create();
+            }
+            size_t const length = merge_pass(group_runs, *tmp_tape, ascending);
+            merged.push_back({std::move(tmp_tape), length, !ascending});
+        }
+        std::move(runs.begin() + static_cast<std::ptrdiff_t>(mergeable), runs.end(),
+                  std::back_inserter(merged));
+        runs = std::move(merged);
+    }
+
+    if (progress != nullptr) {
+        progress->StartPass();
+    }
+    merge_pass(runs, output_tape, true);
+}
@@ -0,0 +1,179 @@
+#include "scheduled_tape.h"
+
+#include <atomic>
+
+namespace {
+MoveDirection Opposite(MoveDirection const direction) {
+    return direction == MoveDirection::kForward ? MoveDirection::kBackward
+                                                : MoveDirection::kForward;
+}
+}  // namespace
+
+ScheduledTape::ScheduledTape(ITape& tape, TapeIoScheduler& scheduler, size_t const readahead)
+    : tape_(tape), scheduler_(scheduler), drive_(scheduler.Acquire()), readahead_(readahead) {}
+
+ScheduledTape::ScheduledTape(std::unique_ptr<ITape> tape, TapeIoScheduler& scheduler,
+                             size_t const readahead)
+    : owned_tape_(std::move(tape)),
+      tape_(*owned_tape_),
+      scheduler_(scheduler),
+      drive_(scheduler.Acquire()),
+      readahead_(readahead) {}
+
+ScheduledTape::~ScheduledTape() {
+    prefetched_.clear();
+    drive_.Submit([] {}).wait();
+    scheduler_.Release(drive_);
+}
+
+bool ScheduledTape::Read(int32_t& value) {
+    ThrowIfFailed();
+    if (!current_) {
+        DropPrefetched(true);
+        current_ = drive_.Submit([&tape = tape_] {
+                             Step step;
+                             try {
+                                 step.has_value = tape.Read(step.value);
+                             } catch (...) {
+                                 step.error = std::current_exception();
+                             }
+                             return step;
+                         }).get();
+    }
+
+    if (current_->error) {
+        auto const error = current_->error;
+        current_.reset();
+        std::rethrow_exception(error);
+    }
+    if (current_->has_value) {
+        value = current_->value;
+    }
+    return current_->has_value;
+}
+
+void ScheduledTape::Write(int32_t const value) {
+    ThrowIfFailed();
+    DropPrefetched(true);
+    current_.reset();
+    Post([value](ITape& tape) { tape.Write(value); });
+}
+
+void ScheduledTape::Move(MoveDirection const direction) {
+    ThrowIfFailed();
+    if (stream_direction_ != direction) {
+        bool const was_read = current_.has_value();
+        DropPrefetched(true);
+        if (was_read && readahead_ > 0) {
+            stream_direction_ = direction;
+            Prefetch();
+        }
+    }
+
+    if (stream_direction_ == direction) {
+        Step step = prefetched_.front().get();
+        prefetched_.pop_front();
+        if (!step.moved) {
+            DropPrefetched(true);
+            current_.reset();
+            std::rethrow_exception(step.error);
+        }
+        current_ = step;
+        Prefetch();
+        return;
+    }
+
+    current_.reset();
+    Post([direction](ITape& tape) { tape.Move(direction); });
+}
+
+void ScheduledTape::Rewind() {
+    ThrowIfFailed();
+    DropPrefetched(false);
+    current_.reset();
+    Post([](ITape& tape) { tape.Rewind(); });
+}
+
+void ScheduledTape::Flush() {
+    drive_.Submit([] {}).get();
+    ThrowIfFailed();
+}
+
+void ScheduledTape::Post(std::function<void(ITape&)> operation) {
+    drive_.Post([&tape = tape_, deferred = deferred_error_, operation = std::move(operation)] {
+        try {
+            operation(tape);
+        } catch (...) {
+            std::lock_guard lock(deferred->mutex);
+            if (!deferred->error) {
+                deferred->error = std::current_exception();
+            }
+        }
+    });
+}
+
+void ScheduledTape::Prefetch() {
+    auto const direction = *stream_direction_;
+    while (prefetched_.size() < readahead_) {
+        prefetched_.push_back(drive_.Submit([&tape = tape_, direction] {
+            Step step;
+            try {
+                tape.Move(direction);
+                step.moved = true;
+                step.has_value = tape.Read(step.value);
+            } catch (...) {
+                step.error = std::current_exception();
+            }
+            return step;
+        }));
+    }
+}
+
+void ScheduledTape::DropPrefetched(bool const restore_position) {
+    if (prefetched_.empty()) {
+        stream_direction_.reset();
+        return;
+    }
+
+    // Steps run in FIFO order on the drive, so by the time the undo task runs every dropped step
+    // has finished and reported whether it moved the head.
+    auto moved = std::make_shared<std::atomic<size_t>>(0);
+    auto const opposite = Opposite(*stream_direction_);
+    for (auto& step : prefetched_) {
+        auto shared = std::make_shared<std::future<Step>>(std::move(step));
+        drive_.Post([shared, moved] {
+            if (shared->get().moved) {
+                ++*moved;
+            }
+        });
+    }
+    prefetched_.clear();
+    stream_direction_.reset();
+
+    if (restore_position) {
+        Post([moved, opposite](ITape& tape) {
+            for (size_t i = 0; i < *moved; ++i) {
+                tape.Move(opposite);
+            }
+        });
+    }
+}
+
+void ScheduledTape::ThrowIfFailed() {
+    std::exception_ptr error;
+    {
+        std::lock_guard lock(deferred_error_->mutex);
+        std::swap(error, deferred_error_->error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+ScheduledTapeFactory::ScheduledTapeFactory(std::unique_ptr<ITapeFactory> factory,
+                                           TapeIoScheduler& scheduler, size_t const readahead)
+    : factory_(std::move(factory)), scheduler_(scheduler), readahead_(readahead) {}
+
+std::unique_ptr<ITape> ScheduledTapeFactory::Create() {
+    return std::make_unique<ScheduledTape>(factory_->Create(), scheduler_, readahead_);
+}
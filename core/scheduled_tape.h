@@ -0,0 +1,75 @@
+#pragma once
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "i_tape.h"
+#include "tape_io_scheduler.h"
+#include "tmp_tape_factory.h"
+
+// Issues the operations of a wrapped tape on a dedicated drive of a TapeIoScheduler.
+// Writes, moves and rewinds are queued without blocking (write-behind). Once the tape is read and
+// moved in some direction, the following moves and reads in that direction are prefetched.
+// Errors of queued operations are rethrown by the next call or by Flush.
+class ScheduledTape : public ITape {
+public:
+    static constexpr size_t kDefaultReadahead = 4;
+
+    ScheduledTape(ITape& tape, TapeIoScheduler& scheduler, size_t readahead = kDefaultReadahead);
+    ScheduledTape(std::unique_ptr<ITape> tape, TapeIoScheduler& scheduler,
+                  size_t readahead = kDefaultReadahead);
+    ~ScheduledTape() override;
+
+    bool Read(int32_t& value) override;
+    void Write(int32_t value) override;
+    void Move(MoveDirection direction) override;
+    void Rewind() override;
+
+    void Flush();
+
+private:
+    struct Step {
+        bool moved = false;
+        bool has_value = false;
+        int32_t value = 0;
+        std::exception_ptr error;
+    };
+
+    struct DeferredError {
+        std::mutex mutex;
+        std::exception_ptr error;
+    };
+
+    std::unique_ptr<ITape> owned_tape_;
+    ITape& tape_;
+    TapeIoScheduler& scheduler_;
+    TapeDrive& drive_;
+    size_t readahead_;
+
+    std::optional<MoveDirection> stream_direction_;
+    std::deque<std::future<Step>> prefetched_;
+    std::optional<Step> current_;
+    std::shared_ptr<DeferredError> deferred_error_ = std::make_shared<DeferredError>();
+
+    void Post(std::function<void(ITape&)> operation);
+    void Prefetch();
+    void DropPrefetched(bool restore_position);
+    void ThrowIfFailed();
+};
+
+// Wraps every tape created by the inner factory into a ScheduledTape.
+class ScheduledTapeFactory : public ITapeFactory {
+public:
+    ScheduledTapeFactory(std::unique_ptr<ITapeFactory> factory, TapeIoScheduler& scheduler,
+                         size_t readahead = ScheduledTape::kDefaultReadahead);
+
+    std::unique_ptr<ITape> Create() override;
+
+private:
+    std::unique_ptr<ITapeFactory> factory_;
+    TapeIoScheduler& scheduler_;
+    size_t readahead_;
+};
@@ -0,0 +1,281 @@
+#include "sharded_sorter.h"
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+
+#include "tape.h"
+#include "tmp_tape_factory.h"
+
+namespace {
+constexpr size_t kChunkElements = 4096;
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+std::runtime_error SocketError(std::string const& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+void SendAll(int const socket, void const* data, size_t size) {
+    auto const* bytes = static_cast<char const*>(data);
+    while (size > 0) {
+        ssize_t const sent = send(socket, bytes, size, kSendFlags);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw SocketError("Failed to send shard data");
+        }
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+}
+
+template <typename Consumer>
+void ReceiveAll(int const socket, Consumer&& consume) {
+    std::vector<char> buffer(kChunkElements * sizeof(int32_t));
+    size_t filled = 0;
+    while (true) {
+        ssize_t const received = recv(socket, buffer.data() + filled, buffer.size() - filled, 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw SocketError("Failed to receive shard data");
+        }
+        if (received == 0) {
+            break;
+        }
+        filled += static_cast<size_t>(received);
+
+        size_t const complete = filled - filled % sizeof(int32_t);
+        for (size_t offset = 0; offset < complete; offset += sizeof(int32_t)) {
+            int32_t value;
+            std::memcpy(&value, buffer.data() + offset, sizeof(value));
+            consume(value);
+        }
+        std::memmove(buffer.data(), buffer.data() + complete, filled - complete);
+        filled -= complete;
+    }
+
+    if (filled != 0) {
+        throw std::runtime_error("Truncated shard stream");
+    }
+}
+}  // namespace
+
+ShardedSorter::ShardedSorter(size_t const shards, size_t const memory_block, std::string work_dir,
+                             TapeDelays const& delays, SortOptions const& options)
+    : shards_(shards),
+      memory_block_(memory_block),
+      work_dir_(std::move(work_dir)),
+      delays_(delays),
+      options_(options) {
+    if (shards_ == 0) {
+        throw std::runtime_error("Shard count must be greater than zero");
+    }
+    if (options_.memory_budget != nullptr) {
+        worker_memory_ = options_.memory_budget->Available() / shards_;
+        options_.memory_budget = nullptr;
+    }
+}
+
+std::vector<int32_t> ShardedSorter::ChooseSplitters(std::vector<int32_t> samples,
+                                                    size_t const shards) {
+    std::vector<int32_t> splitters;
+    if (samples.empty()) {
+        return splitters;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    for (size_t shard = 1; shard < shards; ++shard) {
+        splitters.push_back(samples[shard * samples.size() / shards]);
+    }
+    return splitters;
+}
+
+std::vector<int32_t> ShardedSorter::Sample(ITape& input_tape) const {
+    size_t const capacity = shards_ * kSamplesPerShard;
+    std::vector<int32_t> samples;
+    samples.reserve(capacity);
+    std::mt19937_64 random(capacity);
+
+    input_tape.Rewind();
+    size_t seen = 0;
+    int32_t value;
+    while (input_tape.Read(value)) {
+        if (samples.size() < capacity) {
+            samples.push_back(value);
+        } else {
+            size_t const slot = std::uniform_int_distribution<size_t>(0, seen)(random);
+            if (slot < capacity) {
+                samples[slot] = value;
+            }
+        }
+        ++seen;
+        input_tape.Move(MoveDirection::kForward);
+    }
+    return samples;
+}
+
+void ShardedSorter::RunWorker(int const socket, size_t const shard) const {
+    auto const dir = std::filesystem::path(work_dir_) / ("shard_" + std::to_string(shard));
+    std::filesystem::create_directories(dir);
+    std::string const input_path = (dir / "input").string();
+    std::string const output_path = (dir / "output").string();
+
+    {
+        std::ofstream input(input_path, std::ios::binary);
+        ReceiveAll(socket, [&input](int32_t const value) {
+            input.write(reinterpret_cast<char const*>(&value), sizeof(value));
+        });
+        if (!input) {
+            throw std::runtime_error("Cannot write shard input: " + input_path);
+        }
+        std::ofstream output(output_path, std::ios::binary);
+    }
+
+    {
+        std::optional<MemoryBudget> budget;
+        if (worker_memory_ != 0) {
+            budget.emplace(worker_memory_);
+        }
+        MemoryBudget* const worker_budget = budget ? &*budget : nullptr;
+        Tape input_tape(input_path, delays_, worker_budget);
+        Tape output_tape(output_path, delays_, worker_budget);
+        SortOptions options = options_;
+        options.expected_elements = std::filesystem::file_size(input_path) / sizeof(int32_t);
+        options.memory_budget = worker_budget;
+        TapeSorter sorter(memory_block_,
+                          std::make_unique<TmpTapeFactory>(dir.string(), delays_, worker_budget),
+                          options);
+        sorter.Sort(input_tape, output_tape);
+    }
+
+    std::ifstream output(output_path, std::ios::binary);
+    std::vector<char> chunk(kChunkElements * sizeof(int32_t));
+    while (output.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) ||
+           output.gcount() > 0) {
+        SendAll(socket, chunk.data(), static_cast<size_t>(output.gcount()));
+    }
+    output.close();
+    std::filesystem::remove_all(dir);
+}
+
+std::vector<ShardedSorter::Worker> ShardedSorter::SpawnWorkers() const {
+    std::vector<Worker> workers;
+    try {
+        for (size_t shard = 0; shard < shards_; ++shard) {
+            int sockets[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+                throw SocketError("Failed to create shard socket");
+            }
+#ifdef SO_NOSIGPIPE
+            int const enable = 1;
+            setsockopt(sockets[0], SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+            setsockopt(sockets[1], SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+
+            pid_t const pid = fork();
+            if (pid < 0) {
+                close(sockets[0]);
+                close(sockets[1]);
+                throw SocketError("Failed to start shard worker");
+            }
+
+            if (pid == 0) {
+                close(sockets[0]);
+                for (auto const& worker : workers) {
+                    close(worker.socket);
+                }
+                int status = 0;
+                try {
+                    RunWorker(sockets[1], shard);
+                } catch (std::exception const& e) {
+                    std::cerr << "Shard " << shard << " failed: " << e.what() << std::endl;
+                    status = 1;
+                }
+                close(sockets[1]);
+                _exit(status);
+            }
+
+            close(sockets[1]);
+            workers.push_back({pid, sockets[0]});
+        }
+    } catch (...) {
+        WaitWorkers(workers);
+        throw;
+    }
+    return workers;
+}
+
+bool ShardedSorter::WaitWorkers(std::vector<Worker>& workers) {
+    bool succeeded = true;
+    for (auto& worker : workers) {
+        close(worker.socket);
+        int status = 0;
+        while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        succeeded = succeeded && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    workers.clear();
+    return succeeded;
+}
+
+void ShardedSorter::Sort(ITape& input_tape, ITape& output_tape) const {
+    auto const splitters = ChooseSplitters(Sample(input_tape), shards_);
+    auto workers = SpawnWorkers();
+
+    try {
+        std::vector<std::vector<int32_t>> buffers(workers.size());
+        input_tape.Rewind();
+        int32_t value;
+        while (input_tape.Read(value)) {
+            auto const shard = static_cast<size_t>(
+                    std::upper_bound(splitters.begin(), splitters.end(), value) -
+                    splitters.begin());
+            auto& buffer = buffers[shard];
+            buffer.push_back(value);
+            if (buffer.size() == kChunkElements) {
+                SendAll(workers[shard].socket, buffer.data(), buffer.size() * sizeof(int32_t));
+                buffer.clear();
+            }
+            input_tape.Move(MoveDirection::kForward);
+        }
+
+        for (size_t shard = 0; shard < workers.size(); ++shard) {
+            SendAll(workers[shard].socket, buffers[shard].data(),
+                    buffers[shard].size() * sizeof(int32_t));
+            shutdown(workers[shard].socket, SHUT_WR);
+        }
+
+        output_tape.Rewind();
+        for (auto const& worker : workers) {
+            ReceiveAll(worker.socket, [&output_tape](int32_t const sorted) {
+                output_tape.Write(sorted);
+                output_tape.Move(MoveDirection::kForward);
+            });
+        }
+    } catch (...) {
+        WaitWorkers(workers);
+        throw;
+    }
+
+    if (!WaitWorkers(workers)) {
+        throw std::runtime_error("Shard worker failed");
+    }
+}
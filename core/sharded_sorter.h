@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "i_tape.h"
+#include "tape_config.h"
+#include "tape_sorter.h"
+
+// Range-partitioned sort across worker processes. The coordinator samples the input to pick
+// splitters, streams every shard to its worker over a Unix socket, and concatenates the sorted
+// shards in splitter order. Each worker sorts its shard with TapeSorter in its own directory,
+// within an equal share of what options.memory_budget has available.
+class ShardedSorter {
+public:
+    static constexpr size_t kSamplesPerShard = 64;
+
+    ShardedSorter(size_t shards, size_t memory_block, std::string work_dir,
+                  TapeDelays const& delays, SortOptions const& options = {});
+
+    void Sort(ITape& input_tape, ITape& output_tape) const;
+
+    static std::vector<int32_t> ChooseSplitters(std::vector<int32_t> samples, size_t shards);
+
+private:
+    struct Worker {
+        int pid;
+        int socket;
+    };
+
+    size_t shards_;
+    size_t memory_block_;
+    std::string work_dir_;
+    TapeDelays delays_;
+    SortOptions options_;
+    // Budget of every worker in bytes, 0 if unlimited.
+    size_t worker_memory_ = 0;
+
+    std::vector<int32_t> Sample(ITape& input_tape) const;
+    std::vector<Worker> SpawnWorkers() const;
+    void RunWorker(int socket, size_t shard) const;
+    static bool WaitWorkers(std::vector<Worker>& workers);
+};
@@ -0,0 +1,161 @@
+#include "simulated_tape.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "checksum.h"
+
+SimulatedTape::SimulatedTape(ITape& tape, TapeModel const& model, SimulationStats* stats,
+                             uint64_t const stream)
+    : tape_(tape),
+      model_(model),
+      stats_(stats),
+      random_state_(MixBits(model.seed ^ MixBits(stream))) {}
+
+SimulatedTape::SimulatedTape(std::unique_ptr<ITape> tape, TapeModel const& model,
+                             SimulationStats* stats, uint64_t const stream)
+    : owned_tape_(std::move(tape)),
+      tape_(*owned_tape_),
+      model_(model),
+      stats_(stats),
+      random_state_(MixBits(model.seed ^ MixBits(stream))) {}
+
+bool SimulatedTape::Read(int32_t& value) {
+    Charge(model_.delays.read_delay_ms_ + TransferCost());
+    Count(&SimulationStats::reads);
+    if (Fails(model_.read_error_rate)) {
+        throw TapeFault("Injected read failure at cell " + std::to_string(position_));
+    }
+    return tape_.Read(value);
+}
+
+void SimulatedTape::Write(int32_t const value) {
+    Charge(model_.delays.write_delay_ms_ + TransferCost());
+    Count(&SimulationStats::writes);
+    if (Fails(model_.write_error_rate)) {
+        throw TapeFault("Injected write failure at cell " + std::to_string(position_));
+    }
+    tape_.Write(value);
+}
+
+void SimulatedTape::Move(MoveDirection const direction) {
+    tape_.Move(direction);
+    std::chrono::nanoseconds cost = model_.delays.move_delay_ms_;
+    if (streaming_ != direction) {
+        cost += model_.start_delay;
+        if (streaming_) {
+            Count(&SimulationStats::turnarounds);
+        }
+        streaming_ = direction;
+    }
+    Charge(cost);
+    Count(&SimulationStats::moves);
+    if (direction == MoveDirection::kForward) {
+        ++position_;
+    } else if (position_ > 0) {
+        --position_;
+    }
+}
+
+void SimulatedTape::Rewind() {
+    tape_.Rewind();
+    Charge(model_.delays.rewind_delay_ms_ +
+           model_.rewind_per_cell * static_cast<int64_t>(position_));
+    Count(&SimulationStats::rewinds);
+    position_ = 0;
+    streaming_.reset();
+}
+
+std::chrono::nanoseconds SimulatedTape::TransferCost() const {
+    if (model_.throughput_mb_s == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    // One megabyte per second moves a byte in a microsecond.
+    return std::chrono::nanoseconds(
+            static_cast<int64_t>(std::llround(sizeof(int32_t) * 1000.0 / model_.throughput_mb_s)));
+}
+
+void SimulatedTape::Charge(std::chrono::nanoseconds cost) {
+    if (model_.jitter_percent > 0 && cost.count() > 0) {
+        double const factor = 1 + model_.jitter_percent / 100.0 * (2 * NextUnit() - 1);
+        cost = std::chrono::nanoseconds(std::llround(static_cast<double>(cost.count()) * factor));
+    }
+    elapsed_ += cost;
+    if (stats_ != nullptr) {
+        stats_->elapsed_ns.fetch_add(cost.count(), std::memory_order_relaxed);
+    }
+}
+
+void SimulatedTape::Count(std::atomic<uint64_t> SimulationStats::* counter) const {
+    if (stats_ != nullptr) {
+        (stats_->*counter).fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool SimulatedTape::Fails(double const rate) {
+    if (rate <= 0 || NextUnit() >= rate) {
+        return false;
+    }
+    Count(&SimulationStats::faults);
+    return true;
+}
+
+double SimulatedTape::NextUnit() {
+    random_state_ = MixBits(random_state_);
+    return static_cast<double>(random_state_ >> 11) * 0x1.0p-53;
+}
+
+RetryingTape::RetryingTape(std::unique_ptr<ITape> tape, size_t const max_attempts,
+                           SimulationStats* stats)
+    : tape_(std::move(tape)), max_attempts_(std::max<size_t>(max_attempts, 1)), stats_(stats) {}
+
+template <typename Operation>
+auto RetryingTape::Retry(Operation&& operation) {
+    for (size_t attempt = 1;; ++attempt) {
+        try {
+            return operation();
+        } catch (TapeFault const&) {
+            if (attempt >= max_attempts_) {
+                throw;
+            }
+            if (stats_ != nullptr) {
+                stats_->retries.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+bool RetryingTape::Read(int32_t& value) {
+    return Retry([&] { return tape_->Read(value); });
+}
+
+void RetryingTape::Write(int32_t const value) {
+    Retry([&] { tape_->Write(value); });
+}
+
+void RetryingTape::Move(MoveDirection const direction) {
+    Retry([&] { tape_->Move(direction); });
+}
+
+void RetryingTape::Rewind() {
+    Retry([&] { tape_->Rewind(); });
+}
+
+SimulatedTapeFactory::SimulatedTapeFactory(std::unique_ptr<ITapeFactory> factory,
+                                           TapeModel const& model, SimulationStats* stats,
+                                           size_t const max_attempts, uint64_t const first_stream)
+    : factory_(std::move(factory)),
+      model_(model),
+      stats_(stats),
+      max_attempts_(max_attempts),
+      next_stream_(first_stream) {}
+
+std::unique_ptr<ITape> SimulatedTapeFactory::Create() {
+    std::unique_ptr<ITape> tape =
+            std::make_unique<SimulatedTape>(factory_->Create(), model_, stats_, next_stream_++);
+    if (max_attempts_ > 1) {
+        tape = std::make_unique<RetryingTape>(std::move(tape), max_attempts_, stats_);
+    }
+    return tape;
+}
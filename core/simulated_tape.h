@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+#include "i_tape.h"
+#include "tape_config.h"
+#include "tmp_tape_factory.h"
+
+// An injected read or write failure. The failed operation has no effect, so it can be retried.
+class TapeFault : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Totals over the tapes of one simulation. Tapes may update them from several I/O workers.
+struct SimulationStats {
+    std::atomic<int64_t> elapsed_ns{0};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> writes{0};
+    std::atomic<uint64_t> moves{0};
+    std::atomic<uint64_t> turnarounds{0};
+    std::atomic<uint64_t> rewinds{0};
+    std::atomic<uint64_t> faults{0};
+    std::atomic<uint64_t> retries{0};
+
+    std::chrono::nanoseconds Elapsed() const {
+        return std::chrono::nanoseconds(elapsed_ns.load(std::memory_order_relaxed));
+    }
+};
+
+// Charges the operations of a wrapped tape to a simulated clock following a TapeModel, and fails
+// reads and writes at the model's error rates before they reach the wrapped tape. Jitter and
+// failures come from a generator seeded with the model seed and the stream number, so a run with
+// the same tapes created in the same order repeats exactly.
+class SimulatedTape : public ITape {
+public:
+    SimulatedTape(ITape& tape, TapeModel const& model, SimulationStats* stats = nullptr,
+                  uint64_t stream = 0);
+    SimulatedTape(std::unique_ptr<ITape> tape, TapeModel const& model,
+                  SimulationStats* stats = nullptr, uint64_t stream = 0);
+
+    bool Read(int32_t& value) override;
+    void Write(int32_t value) override;
+    void Move(MoveDirection direction) override;
+    void Rewind() override;
+
+    // Simulated time spent by this tape.
+    std::chrono::nanoseconds Elapsed() const {
+        return elapsed_;
+    }
+
+private:
+    std::unique_ptr<ITape> owned_tape_;
+    ITape& tape_;
+    TapeModel model_;
+    SimulationStats* stats_;
+    uint64_t random_state_;
+
+    size_t position_ = 0;
+    std::optional<MoveDirection> streaming_;
+    std::chrono::nanoseconds elapsed_{0};
+
+    std::chrono::nanoseconds TransferCost() const;
+    void Charge(std::chrono::nanoseconds cost);
+    void Count(std::atomic<uint64_t> SimulationStats::* counter) const;
+    bool Fails(double rate);
+    double NextUnit();
+};
+
+// Repeats an operation of the wrapped tape that failed with a TapeFault, giving up after
+// max_attempts attempts in all.
+class RetryingTape : public ITape {
+public:
+    RetryingTape(std::unique_ptr<ITape> tape, size_t max_attempts,
+                 SimulationStats* stats = nullptr);
+
+    bool Read(int32_t& value) override;
+    void Write(int32_t value) override;
+    void Move(MoveDirection direction) override;
+    void Rewind() override;
+
+private:
+    std::unique_ptr<ITape> tape_;
+    size_t max_attempts_;
+    SimulationStats* stats_;
+
+    template <typename Operation>
+    auto Retry(Operation&& operation);
+};
+
+// Wraps every tape created by the inner factory into a SimulatedTape with its own stream number,
+// and into a RetryingTape when more than one attempt is allowed.
+class SimulatedTapeFactory : public ITapeFactory {
+public:
+    SimulatedTapeFactory(std::unique_ptr<ITapeFactory> factory, TapeModel const& model,
+                         SimulationStats* stats = nullptr, size_t max_attempts = 1,
+                         uint64_t first_stream = 0);
+
+    std::unique_ptr<ITape> Create() override;
+
+private:
+    std::unique_ptr<ITapeFactory> factory_;
+    TapeModel model_;
+    SimulationStats* stats_;
+    size_t max_attempts_;
+    uint64_t next_stream_;
+};
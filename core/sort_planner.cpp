@@ -0,0 +1,143 @@
+#include "sort_planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+std::vector<size_t> Candidates(size_t const max_value) {
+    std::vector<size_t> candidates = {max_value};
+    for (size_t value = 1; value < max_value; value *= 2) {
+        candidates.push_back(value);
+    }
+    std::sort(candidates.begin(), candidates.end(), std::greater<>());
+    return candidates;
+}
+
+double Log2(size_t const value) {
+    return value > 1 ? std::log2(static_cast<double>(value)) : 0.0;
+}
+}  // namespace
+
+SortOptions SortPlan::ToOptions(size_t const expected_elements) const {
+    return {fan_in, expected_elements, strategy};
+}
+
+SortPlan SortPlanner::Evaluate(PlanRequest const& request, size_t const block_size,
+                               size_t const fan_in, MergeStrategy const strategy) {
+    SortPlan plan;
+    plan.block_size = std::max<size_t>(block_size, 1);
+    plan.fan_in = fan_in;
+    plan.strategy = strategy;
+
+    size_t const elements = request.elements;
+    plan.runs = (elements + plan.block_size - 1) / plan.block_size;
+    plan.passes = TapeSorter::CountPasses(plan.runs, fan_in);
+
+    auto const& delays = request.delays;
+    double const element_cost = static_cast<double>(
+            (delays.read_delay_ms_ + delays.write_delay_ms_ + 2 * delays.move_delay_ms_).count());
+    double const rewind_cost = static_cast<double>(delays.rewind_delay_ms_.count());
+    double const n = static_cast<double>(elements);
+
+    size_t rewinds = 2;
+    if (strategy == MergeStrategy::kRewind) {
+        for (size_t runs = plan.runs, pass = 0; pass < plan.passes; ++pass) {
+            rewinds += runs;
+            runs = fan_in < 2 ? 1 : (runs + fan_in - 1) / fan_in;
+        }
+    }
+
+    size_t const merge_width = fan_in < 2 ? plan.runs : std::min(fan_in, plan.runs);
+    double const compares = n * Log2(std::min(plan.block_size, std::max<size_t>(elements, 1))) +
+                            static_cast<double>(plan.passes) * n * Log2(merge_width);
+
+    size_t tapes = 0;
+    for (size_t runs = plan.runs, pass = 1; pass <= plan.passes; ++pass) {
+        tapes += runs;
+        runs = fan_in < 2 ? 1 : (runs + fan_in - 1) / fan_in;
+    }
+
+    plan.predicted_time = SortPlan::Duration(
+            element_cost * n * static_cast<double>(plan.passes + 1) +
+            rewind_cost * static_cast<double>(rewinds) + kCompareCostMs * compares +
+            kRunOverheadMs * static_cast<double>(tapes));
+    return plan;
+}
+
+SortPlan SortPlanner::Plan(PlanRequest const& request) {
+    size_t max_block = request.block_size;
+    if (max_block == 0) {
+        max_block = std::max<size_t>(TapeSorter::MaxBlockSize(request.memory_bytes), 1);
+        max_block = std::min(max_block, std::max<size_t>(request.elements, 1));
+    }
+    auto const block_sizes =
+            request.block_size == 0 ? Candidates(max_block) : std::vector<size_t>{max_block};
+
+    size_t max_fan_in = 0;
+    if (request.max_tapes > 0) {
+        max_fan_in = std::max<size_t>(request.max_tapes - 1, 2);
+    }
+    if (request.memory_bytes > 0) {
+        size_t const memory_fan_in =
+                std::max<size_t>(request.memory_bytes / TapeSorter::kMergeBytesPerRun, 2);
+        max_fan_in = max_fan_in == 0 ? memory_fan_in : std::min(max_fan_in, memory_fan_in);
+    }
+    SortPlan best;
+    bool found = false;
+    for (auto const block_size : block_sizes) {
+        size_t const runs = (request.elements + block_size - 1) / block_size;
+        std::vector<size_t> fan_ins = {0};
+        if (max_fan_in != 0 && max_fan_in < runs) {
+            fan_ins = Candidates(max_fan_in);
+            std::erase_if(fan_ins, [](size_t const fan_in) { return fan_in < 2; });
+        }
+
+        for (auto const fan_in : fan_ins) {
+            for (auto const strategy : {MergeStrategy::kReadBackward, MergeStrategy::kRewind}) {
+                auto const plan = Evaluate(request, block_size, fan_in, strategy);
+                if (!found || plan.predicted_time < best.predicted_time) {
+                    best = plan;
+                    found = true;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+SortPlan SortPlanner::PlanUnknownSize(PlanRequest const& request) {
+    SortPlan plan;
+    plan.block_size = request.block_size;
+    if (plan.block_size == 0) {
+        plan.block_size = std::max<size_t>(TapeSorter::MaxBlockSize(request.memory_bytes), 1);
+    }
+    if (request.max_tapes > 0) {
+        plan.fan_in = std::max<size_t>(request.max_tapes - 1, 2);
+    }
+    plan.strategy = MergeStrategy::kReadBackward;
+    return plan;
+}
+
+void SortPlanner::Explain(std::ostream& out, PlanRequest const& request, SortPlan const& plan) {
+    out << "Sort plan for " << request.elements << " elements";
+    if (request.memory_bytes > 0) {
+        out << " within " << request.memory_bytes << " bytes";
+    }
+    out << ":" << std::endl;
+    out << "  block size:      " << plan.block_size << " elements ("
+        << plan.block_size * sizeof(int32_t) << " bytes)" << std::endl;
+    out << "  runs:            " << plan.runs << std::endl;
+    out << "  fan-in:          ";
+    if (plan.fan_in == 0) {
+        out << "unlimited";
+    } else {
+        out << plan.fan_in;
+    }
+    out << std::endl;
+    out << "  merge passes:    " << plan.passes << std::endl;
+    out << "  strategy:        "
+        << (plan.strategy == MergeStrategy::kReadBackward ? "read-backward" : "rewind")
+        << std::endl;
+    out << "  predicted time:  " << plan.predicted_time.count() << " ms" << std::endl;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+#include "tape_config.h"
+#include "tape_sorter.h"
+
+struct PlanRequest {
+    size_t elements = 0;
+    size_t memory_bytes = 0;
+    // Tapes that can be mounted at once, including the output tape. 0 if unlimited.
+    size_t max_tapes = 0;
+    // Fixed block size to plan around, 0 lets the planner choose it.
+    size_t block_size = 0;
+    TapeDelays delays;
+};
+
+struct SortPlan {
+    using Duration = std::chrono::duration<double, std::milli>;
+
+    size_t block_size = 1;
+    size_t fan_in = 0;
+    size_t runs = 0;
+    size_t passes = 1;
+    MergeStrategy strategy = MergeStrategy::kReadBackward;
+    Duration predicted_time{0};
+
+    [[nodiscard]] SortOptions ToOptions(size_t expected_elements) const;
+};
+
+// Picks block size, fan-in and merge strategy with the lowest predicted time from a cost model
+// of the tape delays and the comparisons made by the sorter.
+class SortPlanner {
+public:
+    static constexpr double kCompareCostMs = 2e-6;
+    // Creating, opening and later removing the temp tape that holds a run.
+    static constexpr double kRunOverheadMs = 0.1;
+
+    static SortPlan Plan(PlanRequest const& request);
+
+    // For streamed input of unknown size: the largest block the memory allows, a fan-in limited
+    // only by the tape count and read-backward merging. request.elements is ignored.
+    static SortPlan PlanUnknownSize(PlanRequest const& request);
+
+    static SortPlan Evaluate(PlanRequest const& request, size_t block_size, size_t fan_in,
+                             MergeStrategy strategy);
+
+    static void Explain(std::ostream& out, PlanRequest const& request, SortPlan const& plan);
+};
@@ -0,0 +1,77 @@
+#include "sort_progress.h"
+
+std::optional<double> ProgressSnapshot::Fraction() const {
+    if (phase == SortPhase::kDone) {
+        return 1.0;
+    }
+    size_t const elements = expected_elements != 0 ? expected_elements
+                            : phase == SortPhase::kMerge ? elements_split
+                                                         : 0;
+    if (elements == 0) {
+        return std::nullopt;
+    }
+    // Until the runs are counted, assume they are merged in a single pass. Nothing is split when
+    // already sorted tapes are merged.
+    size_t const split_work = phase == SortPhase::kMerge && elements_split == 0 ? 0 : 1;
+    double const work =
+            static_cast<double>(elements) * (split_work + std::max<size_t>(merge_passes, 1));
+    double const done = static_cast<double>(elements_split + elements_merged);
+    return std::min(done / work, 1.0);
+}
+
+double ProgressSnapshot::Throughput() const {
+    if (elapsed.count() <= 0) {
+        return 0;
+    }
+    return static_cast<double>(elements_split + elements_merged) / elapsed.count();
+}
+
+std::optional<ProgressSnapshot::Duration> ProgressSnapshot::Eta() const {
+    auto const fraction = Fraction();
+    if (!fraction || *fraction <= 0) {
+        return std::nullopt;
+    }
+    return elapsed * ((1 - *fraction) / *fraction);
+}
+
+SortProgress::SortProgress(size_t const expected_elements)
+    : expected_elements_(expected_elements) {}
+
+ProgressSnapshot SortProgress::Snapshot() const {
+    ProgressSnapshot snapshot;
+    snapshot.phase = static_cast<SortPhase>(phase_.load(std::memory_order_relaxed));
+    snapshot.expected_elements = expected_elements_;
+    snapshot.elements_split = elements_split_.load(std::memory_order_relaxed);
+    snapshot.runs_written = runs_written_.load(std::memory_order_relaxed);
+    snapshot.merge_pass = merge_pass_.load(std::memory_order_relaxed);
+    snapshot.merge_passes = merge_passes_.load(std::memory_order_relaxed);
+    snapshot.elements_merged = elements_merged_.load(std::memory_order_relaxed);
+    snapshot.elapsed = Clock::now() - start_;
+    return snapshot;
+}
+
+ProgressReporter::ProgressReporter(SortProgress const& progress,
+                                   std::chrono::milliseconds const interval, Callback callback)
+    : progress_(progress),
+      interval_(interval),
+      callback_(std::move(callback)),
+      thread_(&ProgressReporter::Run, this) {}
+
+ProgressReporter::~ProgressReporter() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    stopped_.notify_one();
+    thread_.join();
+    callback_(progress_.Snapshot());
+}
+
+void ProgressReporter::Run() {
+    std::unique_lock lock(mutex_);
+    while (!stopped_.wait_for(lock, interval_, [this] { return stop_; })) {
+        lock.unlock();
+        callback_(progress_.Snapshot());
+        lock.lock();
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+enum class SortPhase { kSplit, kMerge, kDone };
+
+struct ProgressSnapshot {
+    using Duration = std::chrono::duration<double>;
+
+    SortPhase phase = SortPhase::kSplit;
+    // Elements the sort is expected to read, 0 if unknown until the split is over.
+    size_t expected_elements = 0;
+    size_t elements_split = 0;
+    size_t runs_written = 0;
+    // 1-based merge pass in progress and the number of passes planned for the runs.
+    size_t merge_pass = 0;
+    size_t merge_passes = 0;
+    // Elements written by all merge passes so far.
+    size_t elements_merged = 0;
+    Duration elapsed{0};
+
+    // Share of the split and merge work done, nullopt while the input size is unknown.
+    [[nodiscard]] std::optional<double> Fraction() const;
+    // Elements split or merged per second.
+    [[nodiscard]] double Throughput() const;
+    [[nodiscard]] std::optional<Duration> Eta() const;
+};
+
+// Counters updated by the sorting thread and sampled by others. Updates are plain relaxed stores
+// as there is a single writer, so hooks in per-element loops cost no more than a store.
+class SortProgress {
+public:
+    explicit SortProgress(size_t expected_elements = 0);
+
+    void StartSplit() {
+        Store(phase_, static_cast<size_t>(SortPhase::kSplit));
+    }
+
+    void AddSplit() {
+        Increment(elements_split_);
+    }
+
+    void AddRun() {
+        Increment(runs_written_);
+    }
+
+    void StartMerge(size_t passes) {
+        Store(merge_passes_, passes);
+        Store(phase_, static_cast<size_t>(SortPhase::kMerge));
+    }
+
+    void StartPass() {
+        Increment(merge_pass_);
+        Store(merge_passes_, std::max(merge_passes_.load(std::memory_order_relaxed),
+                                      merge_pass_.load(std::memory_order_relaxed)));
+    }
+
+    void AddMerged() {
+        Increment(elements_merged_);
+    }
+
+    void Finish() {
+        Store(phase_, static_cast<size_t>(SortPhase::kDone));
+    }
+
+    [[nodiscard]] ProgressSnapshot Snapshot() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point start_ = Clock::now();
+    size_t expected_elements_;
+    std::atomic<size_t> phase_ = static_cast<size_t>(SortPhase::kSplit);
+    std::atomic<size_t> elements_split_ = 0;
+    std::atomic<size_t> runs_written_ = 0;
+    std::atomic<size_t> merge_pass_ = 0;
+    std::atomic<size_t> merge_passes_ = 0;
+    std::atomic<size_t> elements_merged_ = 0;
+
+    static void Store(std::atomic<size_t>& counter, size_t const value) {
+        counter.store(value, std::memory_order_relaxed);
+    }
+
+    static void Increment(std::atomic<size_t>& counter) {
+        Store(counter, counter.load(std::memory_order_relaxed) + 1);
+    }
+};
+
+// Samples a SortProgress on its own thread and passes every snapshot to the callback, once per
+// interval and a last time when destroyed.
+class ProgressReporter {
+public:
+    using Callback = std::function<void(ProgressSnapshot const&)>;
+
+    ProgressReporter(SortProgress const& progress, std::chrono::milliseconds interval,
+                     Callback callback);
+    ~ProgressReporter();
+
+    ProgressReporter(ProgressReporter const&) = delete;
+    ProgressReporter& operator=(ProgressReporter const&) = delete;
+
+private:
+    SortProgress const& progress_;
+    std::chrono::milliseconds interval_;
+    Callback callback_;
+
+    std::mutex mutex_;
+    std::condition_variable stopped_;
+    bool stop_ = false;
+    std::thread thread_;
+
+    void Run();
+};
@@ -0,0 +1,255 @@
+#include "stream_tape.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+std::runtime_error IoError(std::string const& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+size_t BufferBytes(MemoryBudget* budget, size_t const requested, size_t const minimum) {
+    size_t bytes = std::max(requested, minimum);
+    if (budget != nullptr) {
+        bytes = std::max(std::min(bytes, budget->Available() / 8), minimum);
+    }
+    return bytes;
+}
+
+// The tape buffers whole blocks itself, so the stream is unbuffered. On Linux, a pipe is grown
+// towards the block size for fewer, larger transfers; the system limit may keep it smaller.
+void PrepareStream(std::FILE* file, size_t const bytes) {
+    std::setvbuf(file, nullptr, _IONBF, 0);
+#ifdef F_SETPIPE_SZ
+    int const fd = fileno(file);
+    struct stat status {};
+    if (fstat(fd, &status) == 0 && S_ISFIFO(status.st_mode)) {
+        fcntl(fd, F_SETPIPE_SZ, static_cast<int>(std::min<size_t>(bytes, 1 << 30)));
+    }
+#else
+    (void)bytes;
+#endif
+}
+
+bool IsSpace(char const c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+}  // namespace
+
+StreamInputTape::StreamInputTape(std::FILE* file, StreamFormat const format,
+                                 TapeDelays const& delays, MemoryBudget* budget,
+                                 SortVerifier* verifier, size_t const buffer_bytes)
+    : file_(file),
+      format_(format),
+      delays_(delays),
+      verifier_(verifier),
+      buffer_(BufferBytes(budget, buffer_bytes, kMinBufferBytes), BudgetAllocator<char>(budget)) {
+    PrepareStream(file_, buffer_.size());
+}
+
+bool StreamInputTape::Read(int32_t& value) {
+    std::this_thread::sleep_for(delays_.read_delay_ms_);
+    Fetch();
+    value = value_;
+    return has_value_;
+}
+
+void StreamInputTape::Write(int32_t) {
+    throw std::runtime_error("Cannot write to an input stream tape");
+}
+
+void StreamInputTape::Move(MoveDirection const direction) {
+    std::this_thread::sleep_for(delays_.move_delay_ms_);
+    if (direction == MoveDirection::kBackward) {
+        throw std::runtime_error("Stream tapes only move forward");
+    }
+    Fetch();
+    fetched_ = false;
+    moved_ = true;
+}
+
+void StreamInputTape::Rewind() {
+    std::this_thread::sleep_for(delays_.rewind_delay_ms_);
+    if (moved_) {
+        throw std::runtime_error("Cannot rewind a stream tape once it has moved");
+    }
+}
+
+void StreamInputTape::Fetch() {
+    if (fetched_) {
+        return;
+    }
+    has_value_ = format_ == StreamFormat::kBinary ? NextBinary(value_) : NextText(value_);
+    fetched_ = true;
+    if (has_value_ && verifier_ != nullptr) {
+        verifier_->AddInput(value_);
+    }
+}
+
+bool StreamInputTape::Fill() {
+    if (eof_) {
+        return false;
+    }
+    if (begin_ > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+    }
+    end_ += std::fread(buffer_.data() + end_, 1, buffer_.size() - end_, file_);
+    if (end_ < buffer_.size()) {
+        if (std::ferror(file_)) {
+            throw IoError("Failed to read input stream");
+        }
+        eof_ = true;
+    }
+    return true;
+}
+
+bool StreamInputTape::NextBinary(int32_t& value) {
+    while (end_ - begin_ < sizeof(value)) {
+        if (!Fill()) {
+            if (end_ != begin_) {
+                throw std::runtime_error("Input stream ends inside a cell");
+            }
+            return false;
+        }
+    }
+    std::memcpy(&value, buffer_.data() + begin_, sizeof(value));
+    begin_ += sizeof(value);
+    return true;
+}
+
+bool StreamInputTape::NextText(int32_t& value) {
+    while (true) {
+        while (begin_ < end_ && IsSpace(buffer_[begin_])) {
+            ++begin_;
+        }
+        char const* const token = buffer_.data() + begin_;
+        char const* const last = buffer_.data() + end_;
+        char const* const token_end = std::find_if(token, last, IsSpace);
+        // A number cut off by the end of the buffer is completed by the next read.
+        if (token_end == last && !eof_) {
+            if (begin_ == 0 && end_ == buffer_.size()) {
+                throw std::runtime_error("Number in input stream is too long");
+            }
+            Fill();
+            continue;
+        }
+        if (token == last) {
+            return false;
+        }
+
+        char const* const first = *token == '+' ? token + 1 : token;
+        auto const [ptr, error] = std::from_chars(first, token_end, value);
+        if (error != std::errc() || ptr != token_end || first == token_end) {
+            throw std::runtime_error("Invalid number in input stream: " +
+                                     std::string(token, token_end));
+        }
+        begin_ = static_cast<size_t>(token_end - buffer_.data());
+        return true;
+    }
+}
+
+StreamOutputTape::StreamOutputTape(std::FILE* file, StreamFormat const format,
+                                   TapeDelays const& delays, MemoryBudget* budget,
+                                   SortVerifier* verifier, size_t const values_per_line,
+                                   size_t const buffer_bytes)
+    : file_(file),
+      format_(format),
+      delays_(delays),
+      verifier_(verifier),
+      values_per_line_(std::max<size_t>(values_per_line, 1)),
+      buffer_(BufferBytes(budget, buffer_bytes, kMinBufferBytes), BudgetAllocator<char>(budget)) {
+    PrepareStream(file_, buffer_.size());
+}
+
+StreamOutputTape::~StreamOutputTape() {
+    if (!has_value_ && used_ == 0) {
+        return;
+    }
+    try {
+        Flush();
+    } catch (std::exception const& e) {
+        std::cerr << "Error flushing output stream tape: " << e.what() << std::endl;
+    }
+}
+
+bool StreamOutputTape::Read(int32_t&) {
+    std::this_thread::sleep_for(delays_.read_delay_ms_);
+    return false;
+}
+
+void StreamOutputTape::Write(int32_t const value) {
+    std::this_thread::sleep_for(delays_.write_delay_ms_);
+    value_ = value;
+    has_value_ = true;
+}
+
+void StreamOutputTape::Move(MoveDirection const direction) {
+    std::this_thread::sleep_for(delays_.move_delay_ms_);
+    if (direction == MoveDirection::kBackward) {
+        throw std::runtime_error("Stream tapes only move forward");
+    }
+    if (!has_value_) {
+        throw std::runtime_error("Cannot skip a cell of an output stream tape");
+    }
+    Commit();
+}
+
+void StreamOutputTape::Rewind() {
+    std::this_thread::sleep_for(delays_.rewind_delay_ms_);
+    if (written_ > 0) {
+        throw std::runtime_error("Cannot rewind a stream tape once it has moved");
+    }
+}
+
+void StreamOutputTape::Flush() {
+    if (has_value_) {
+        Commit();
+    }
+    Drain();
+    if (std::fflush(file_) != 0) {
+        throw IoError("Failed to flush output stream");
+    }
+}
+
+void StreamOutputTape::Commit() {
+    // Room for a sign, ten digits and a separator.
+    constexpr size_t kMaxCellBytes = 12;
+    if (buffer_.size() - used_ < kMaxCellBytes) {
+        Drain();
+    }
+
+    char* out = buffer_.data() + used_;
+    if (format_ == StreamFormat::kBinary) {
+        std::memcpy(out, &value_, sizeof(value_));
+        used_ += sizeof(value_);
+    } else {
+        char* const end = std::to_chars(out, out + kMaxCellBytes, value_).ptr;
+        *end = (written_ + 1) % values_per_line_ == 0 ? '\n' : ' ';
+        used_ += static_cast<size_t>(end + 1 - out);
+    }
+    if (verifier_ != nullptr) {
+        verifier_->AddOutput(value_);
+    }
+    has_value_ = false;
+    ++written_;
+}
+
+void StreamOutputTape::Drain() {
+    if (std::fwrite(buffer_.data(), 1, used_, file_) != used_) {
+        throw IoError("Failed to write output stream");
+    }
+    used_ = 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "checksum.h"
+#include "i_tape.h"
+#include "memory_budget.h"
+#include "tape_config.h"
+
+enum class StreamFormat {
+    // Native int32 cells.
+    kBinary,
+    // Decimal numbers separated by whitespace.
+    kText,
+};
+
+// Forward-only tape reading cells from a stream such as stdin or a pipe. It may be
+// rewound only before the head has moved. Every cell is handed to the verifier once it is taken
+// from the stream.
+class StreamInputTape : public ITape {
+public:
+    static constexpr size_t kDefaultBufferBytes = size_t{1} << 20;
+    static constexpr size_t kMinBufferBytes = 4096;
+
+    // With a budget, the buffer is drawn from it and takes at most an eighth of what is available,
+    // but no less than kMinBufferBytes.
+    StreamInputTape(std::FILE* file, StreamFormat format, TapeDelays const& delays,
+                    MemoryBudget* budget = nullptr, SortVerifier* verifier = nullptr,
+                    size_t buffer_bytes = kDefaultBufferBytes);
+
+    bool Read(int32_t& value) override;
+    void Write(int32_t value) override;
+    void Move(MoveDirection direction) override;
+    void Rewind() override;
+
+private:
+    std::FILE* file_;
+    StreamFormat format_;
+    TapeDelays delays_;
+    SortVerifier* verifier_;
+    BudgetVector<char> buffer_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    bool eof_ = false;
+
+    bool fetched_ = false;
+    bool has_value_ = false;
+    int32_t value_ = 0;
+    bool moved_ = false;
+
+    void Fetch();
+    bool Fill();
+    bool NextBinary(int32_t& value);
+    bool NextText(int32_t& value);
+};
+
+// Forward-only tape writing cells to a stream such as stdout or a pipe. A cell reaches
+// the stream once the head moves past it. Text output puts values_per_line numbers on a line.
+class StreamOutputTape : public ITape {
+public:
+    static constexpr size_t kDefaultBufferBytes = StreamInputTape::kDefaultBufferBytes;
+    static constexpr size_t kMinBufferBytes = StreamInputTape::kMinBufferBytes;
+
+    StreamOutputTape(std::FILE* file, StreamFormat format, TapeDelays const& delays,
+                     MemoryBudget* budget = nullptr, SortVerifier* verifier = nullptr,
+                     size_t values_per_line = 1, size_t buffer_bytes = kDefaultBufferBytes);
+    ~StreamOutputTape() override;
+
+    StreamOutputTape(StreamOutputTape const&) = delete;
+    StreamOutputTape& operator=(StreamOutputTape const&) = delete;
+
+    bool Read(int32_t& value) override;
+    void Write(int32_t value) override;
+    void Move(MoveDirection direction) override;
+    void Rewind() override;
+
+    // Writes the cell under the head, if any, and everything buffered to the stream. The stream
+    // itself is flushed but not closed.
+    void Flush();
+
+private:
+    std::FILE* file_;
+    StreamFormat format_;
+    TapeDelays delays_;
+    SortVerifier* verifier_;
+    size_t values_per_line_;
+    BudgetVector<char> buffer_;
+    size_t used_ = 0;
+
+    bool has_value_ = false;
+    int32_t value_ = 0;
+    size_t written_ = 0;
+
+    void Commit();
+    void Drain();
+};
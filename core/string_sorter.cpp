@@ -0,0 +1,378 @@
+#include "string_sorter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+
+#include "parallel_sort.h"
+#include "run_merger.h"
+
+namespace {
+constexpr size_t kCellBytes = sizeof(int32_t);
+
+size_t CellsFor(size_t const bytes) {
+    return (bytes + kCellBytes - 1) / kCellBytes;
+}
+
+void WriteCell(ITape& tape, int32_t const value) {
+    tape.Write(value);
+    tape.Move(MoveDirection::kForward);
+}
+
+int32_t ReadCell(ITape& tape, MoveDirection const direction) {
+    int32_t value;
+    if (direction == MoveDirection::kBackward) {
+        tape.Move(MoveDirection::kBackward);
+    }
+    if (!tape.Read(value)) {
+        throw std::runtime_error("Tape ends inside a string record");
+    }
+    if (direction == MoveDirection::kForward) {
+        tape.Move(MoveDirection::kForward);
+    }
+    return value;
+}
+
+void WriteBytes(ITape& tape, std::string_view const bytes) {
+    for (size_t offset = 0; offset < bytes.size(); offset += kCellBytes) {
+        int32_t cell = 0;
+        std::memcpy(&cell, bytes.data() + offset, std::min(kCellBytes, bytes.size() - offset));
+        WriteCell(tape, cell);
+    }
+}
+
+void ReadBytes(ITape& tape, MoveDirection const direction, char* bytes, size_t const length) {
+    size_t const cells = CellsFor(length);
+    for (size_t idx = 0; idx < cells; ++idx) {
+        size_t const cell_idx = direction == MoveDirection::kForward ? idx : cells - 1 - idx;
+        int32_t const cell = ReadCell(tape, direction);
+        size_t const offset = cell_idx * kCellBytes;
+        std::memcpy(bytes + offset, &cell, std::min(kCellBytes, length - offset));
+    }
+}
+
+int32_t LengthCell(size_t const length) {
+    if (length > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        throw std::runtime_error("String record field is too long for a tape");
+    }
+    return static_cast<int32_t>(length);
+}
+
+uint32_t ParseLength(int32_t const cell) {
+    if (cell < 0) {
+        throw std::runtime_error("String record has a negative length");
+    }
+    return static_cast<uint32_t>(cell);
+}
+
+// Lengths of a record, read from whichever end of it the head is at.
+struct RecordHeader {
+    uint32_t key_length = 0;
+    uint32_t payload_length = 0;
+
+    [[nodiscard]] size_t Bytes() const {
+        return size_t{key_length} + payload_length;
+    }
+};
+
+bool ReadHeader(ITape& tape, MoveDirection const direction, RecordHeader& header) {
+    int32_t first;
+    if (direction == MoveDirection::kForward) {
+        if (!tape.Read(first)) {
+            return false;
+        }
+        tape.Move(MoveDirection::kForward);
+    } else {
+        first = ReadCell(tape, direction);
+    }
+    header.key_length = ParseLength(first);
+    header.payload_length = ParseLength(ReadCell(tape, direction));
+    return true;
+}
+
+// Reads the key and payload of a record whose header was just read into bytes, followed by the
+// lengths at its other end.
+void ReadBody(ITape& tape, MoveDirection const direction, RecordHeader const& header,
+              char* bytes) {
+    if (direction == MoveDirection::kForward) {
+        ReadBytes(tape, direction, bytes, header.key_length);
+        ReadBytes(tape, direction, bytes + header.key_length, header.payload_length);
+    } else {
+        ReadBytes(tape, direction, bytes + header.key_length, header.payload_length);
+        ReadBytes(tape, direction, bytes, header.key_length);
+    }
+    int32_t const payload_length = ReadCell(tape, direction);
+    int32_t const key_length = ReadCell(tape, direction);
+    if (ParseLength(key_length) != header.key_length ||
+        ParseLength(payload_length) != header.payload_length) {
+        throw std::runtime_error("String record lengths do not match at its ends");
+    }
+}
+
+// Holds the current record of a run.
+class StringRunReader {
+public:
+    StringRunReader(ITape& tape, size_t const length, MoveDirection const direction,
+                    MemoryBudget* budget)
+        : tape_(tape),
+          remaining_(length),
+          direction_(direction),
+          bytes_(BudgetAllocator<char>(budget)) {
+        if (direction_ == MoveDirection::kForward) {
+            tape_.Rewind();
+        }
+    }
+
+    bool Next() {
+        if (remaining_ == 0) {
+            return false;
+        }
+        if (!ReadHeader(tape_, direction_, header_)) {
+            throw std::runtime_error("Temporary tape is shorter than its run");
+        }
+        bytes_.resize(header_.Bytes());
+        ReadBody(tape_, direction_, header_, bytes_.data());
+        prefix_ = StringSorter::KeyPrefix(Key());
+        --remaining_;
+        return true;
+    }
+
+    [[nodiscard]] std::string_view Key() const {
+        return {bytes_.data(), header_.key_length};
+    }
+    [[nodiscard]] std::string_view Payload() const {
+        return {bytes_.data() + header_.key_length, header_.payload_length};
+    }
+    [[nodiscard]] uint64_t Prefix() const {
+        return prefix_;
+    }
+
+private:
+    ITape& tape_;
+    size_t remaining_;
+    MoveDirection direction_;
+    BudgetVector<char> bytes_;
+    RecordHeader header_;
+    uint64_t prefix_ = 0;
+};
+
+// An index entry of a record held in the split buffer.
+struct KeyEntry {
+    uint64_t prefix;
+    size_t offset;
+    uint32_t key_length;
+    uint32_t payload_length;
+};
+
+struct HeapElement {
+    uint64_t prefix;
+    size_t run;
+};
+
+static_assert(sizeof(StringRunReader) + sizeof(HeapElement) <= StringSorter::kMergeBytesPerRun);
+}  // namespace
+
+void WriteStringRecord(ITape& tape, std::string_view const key, std::string_view const payload) {
+    int32_t const key_length = LengthCell(key.size());
+    int32_t const payload_length = LengthCell(payload.size());
+    WriteCell(tape, key_length);
+    WriteCell(tape, payload_length);
+    WriteBytes(tape, key);
+    WriteBytes(tape, payload);
+    WriteCell(tape, payload_length);
+    WriteCell(tape, key_length);
+}
+
+bool ReadStringRecord(ITape& tape, StringRecord& record) {
+    RecordHeader header;
+    if (!ReadHeader(tape, MoveDirection::kForward, header)) {
+        return false;
+    }
+    std::string bytes(header.Bytes(), '\0');
+    ReadBody(tape, MoveDirection::kForward, header, bytes.data());
+    record.key = bytes.substr(0, header.key_length);
+    record.payload = bytes.substr(header.key_length);
+    return true;
+}
+
+uint64_t StringSorter::KeyPrefix(std::string_view const key) {
+    uint64_t prefix = 0;
+    for (size_t idx = 0; idx < sizeof(prefix); ++idx) {
+        prefix <<= 8;
+        if (idx < key.size()) {
+            prefix |= static_cast<unsigned char>(key[idx]);
+        }
+    }
+    return prefix;
+}
+
+RunMerger StringSorter::Merger() const {
+    return {*factory_, options_, kMergeBytesPerRun};
+}
+
+std::vector<StringSorter::Run> StringSorter::Split(ITape& input_tape) const {
+    std::vector<Run> runs;
+    auto const merger = Merger();
+    size_t const block_bytes = merger.BlockSize(block_bytes_, 1, sizeof(KeyEntry) * 2);
+    bool const descending =
+            merger.StoreRunsDescending(options_.expected_elements * sizeof(int32_t), block_bytes);
+
+    // Keys and payloads fill the block from its front and their index entries from its back, so
+    // a block holds as many records as fit whatever their sizes.
+    size_t const block_entries = block_bytes / sizeof(KeyEntry);
+    BudgetVector<KeyEntry> block{BudgetAllocator<KeyEntry>(options_.memory_budget)};
+    block.resize(block_entries);
+    char* bytes = reinterpret_cast<char*>(block.data());
+    // Frees the block before allocating the new one, so the budget never holds both.
+    auto const reallocate = [&block, &bytes](size_t const entries) {
+        BudgetVector<KeyEntry>(block.get_allocator()).swap(block);
+        block.resize(entries);
+        bytes = reinterpret_cast<char*>(block.data());
+    };
+
+    auto* progress = options_.progress;
+    if (progress != nullptr) {
+        progress->StartSplit();
+    }
+
+    auto const key = [&bytes](KeyEntry const& entry) {
+        return std::string_view(bytes + entry.offset, entry.key_length);
+    };
+    // Keys with equal prefixes are compared in full, and records with equal keys keep their input
+    // order, which is the order of their offsets. Empty records share the offset of the record
+    // after them, which has a payload if it differs from them, as their keys are equal.
+    auto const less = [&key](KeyEntry const& lhs, KeyEntry const& rhs) {
+        if (lhs.prefix != rhs.prefix) {
+            return lhs.prefix < rhs.prefix;
+        }
+        if (int const order = key(lhs).compare(key(rhs)); order != 0) {
+            return order < 0;
+        }
+        return lhs.offset != rhs.offset ? lhs.offset < rhs.offset
+                                        : lhs.payload_length < rhs.payload_length;
+    };
+
+    RecordHeader header;
+    bool has_record = ReadHeader(input_tape, MoveDirection::kForward, header);
+    while (has_record) {
+        size_t used = 0;
+        size_t first_entry = block.size();
+        auto const fits = [&] {
+            return first_entry > 0 &&
+                   used + header.Bytes() <= (first_entry - 1) * sizeof(KeyEntry);
+        };
+
+        // A record larger than the block is sorted in a block of its own.
+        if (!fits()) {
+            reallocate(header.Bytes() / sizeof(KeyEntry) + 2);
+            first_entry = block.size();
+        }
+        do {
+            ReadBody(input_tape, MoveDirection::kForward, header, bytes + used);
+            KeyEntry entry{0, used, header.key_length, header.payload_length};
+            entry.prefix = KeyPrefix(key(entry));
+            block[--first_entry] = entry;
+            used += header.Bytes();
+            if (progress != nullptr) {
+                progress->AddSplit();
+            }
+            has_record = ReadHeader(input_tape, MoveDirection::kForward, header);
+        } while (has_record && fits());
+
+        auto const entries = std::ranges::subrange(block.begin() + first_entry, block.end());
+        ParallelSort(entries.begin(), entries.end(), less, options_.sort_threads);
+        if (descending) {
+            std::ranges::reverse(entries);
+        }
+        auto tmp_tape = factory_->Create();
+        for (auto const& entry : entries) {
+            WriteStringRecord(*tmp_tape, key(entry),
+                              std::string_view(bytes + entry.offset + entry.key_length,
+                                               entry.payload_length));
+        }
+        runs.push_back({std::move(tmp_tape), entries.size(), descending});
+        if (progress != nullptr) {
+            progress->AddRun();
+        }
+        if (block.size() != block_entries) {
+            reallocate(block_entries);
+        }
+    }
+
+    return runs;
+}
+
+size_t StringSorter::MergePass(std::vector<Run>& runs, ITape& output_tape,
+                               bool const ascending) const {
+    BudgetVector<StringRunReader> readers{
+            BudgetAllocator<StringRunReader>(options_.memory_budget)};
+    readers.reserve(runs.size());
+
+    // A descending pass emits the reverse of the stable ascending merge, so among equal keys the
+    // later run goes first. Keys are compared in full only when their prefixes are equal.
+    auto const compare = [&readers, ascending](HeapElement const& lhs, HeapElement const& rhs) {
+        if (lhs.prefix != rhs.prefix) {
+            return ascending ? lhs.prefix > rhs.prefix : lhs.prefix < rhs.prefix;
+        }
+        int const order = readers[lhs.run].Key().compare(readers[rhs.run].Key());
+        if (order != 0) {
+            return ascending ? order > 0 : order < 0;
+        }
+        return ascending ? lhs.run > rhs.run : lhs.run < rhs.run;
+    };
+
+    BudgetVector<HeapElement> heap{BudgetAllocator<HeapElement>(options_.memory_budget)};
+    heap.reserve(runs.size());
+
+    for (size_t idx = 0; idx < runs.size(); ++idx) {
+        bool const backward = options_.strategy == MergeStrategy::kReadBackward &&
+                              runs[idx].descending == ascending;
+        readers.emplace_back(*runs[idx].tape, runs[idx].length,
+                             backward ? MoveDirection::kBackward : MoveDirection::kForward,
+                             options_.memory_budget);
+        if (readers[idx].Next()) {
+            heap.push_back({readers[idx].Prefix(), idx});
+            std::push_heap(heap.begin(), heap.end(), compare);
+        }
+    }
+
+    auto* progress = options_.progress;
+    size_t written = 0;
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), compare);
+        size_t const run_idx = heap.back().run;
+        heap.pop_back();
+
+        auto& reader = readers[run_idx];
+        WriteStringRecord(output_tape, reader.Key(), reader.Payload());
+        ++written;
+        if (progress != nullptr) {
+            progress->AddMerged();
+        }
+
+        if (reader.Next()) {
+            heap.push_back({reader.Prefix(), run_idx});
+            std::push_heap(heap.begin(), heap.end(), compare);
+        }
+    }
+    return written;
+}
+
+void StringSorter::Sort(ITape& input_tape, ITape& output_tape) const {
+    input_tape.Rewind();
+    auto runs = Split(input_tape);
+    if (!runs.empty()) {
+        output_tape.Rewind();
+        auto const merge_pass = [this](std::vector<Run>& group, ITape& output,
+                                       bool const ascending) {
+            return MergePass(group, output, ascending);
+        };
+        Merger().Merge(runs, output_tape, merge_pass);
+    }
+
+    if (auto* progress = options_.progress; progress != nullptr) {
+        progress->Finish();
+    }
+}
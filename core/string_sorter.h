@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "tape_sorter.h"
+
+// A record with a key and a payload of any length. On a tape it takes the cells
+//   key length, payload length, key bytes, payload bytes, payload length, key length
+// with bytes packed four to a cell and the last cell of the key and of the payload zero padded.
+// The lengths at both ends let a run be read backward as well as forward.
+struct StringRecord {
+    std::string key;
+    std::string payload;
+
+    bool operator==(StringRecord const& other) const = default;
+};
+
+// Writes a record at the head and leaves the head after it.
+void WriteStringRecord(ITape& tape, std::string_view key, std::string_view payload);
+
+// Reads the record at the head and leaves the head after it. Returns false at the end of the tape.
+bool ReadStringRecord(ITape& tape, StringRecord& record);
+
+class RunMerger;
+
+// Stable external sort of string records by key, in the order of unsigned bytes. A block is sorted
+// through an index holding the first bytes of every key as an integer, so most comparisons stay
+// within the index and keys are compared in full only when their prefixes are equal. Merges
+// compare the prefixes of the runs' current keys first as well.
+class StringSorter {
+public:
+    // Bytes a merge needs for every run it reads, besides the record the run holds.
+    static constexpr size_t kMergeBytesPerRun = 128;
+
+    // block_bytes bounds the keys, payloads and index entries of a block held in memory.
+    // options.expected_elements counts the cells of the input tape.
+    StringSorter(size_t const block_bytes, std::unique_ptr<ITapeFactory> factory,
+                 SortOptions const& options = {})
+        : block_bytes_(block_bytes), factory_(std::move(factory)), options_(options) {}
+
+    void Sort(ITape& input_tape, ITape& output_tape) const;
+
+    // The first eight bytes of key, big-endian and zero padded, so prefixes of different keys
+    // order like the keys or are equal.
+    static uint64_t KeyPrefix(std::string_view key);
+
+private:
+    // A stably sorted run. A descending run is the exact reverse of the ascending one, so reading
+    // it backward restores input order among equal keys.
+    struct Run {
+        std::unique_ptr<ITape> tape;
+        size_t length;
+        bool descending;
+    };
+
+    size_t block_bytes_;
+    std::unique_ptr<ITapeFactory> factory_;
+    SortOptions options_;
+
+    size_t MergePass(std::vector<Run>& runs, ITape& output_tape, bool ascending) const;
+
+    std::vector<Run> Split(ITape& input_tape) const;
+
+    [[nodiscard]] RunMerger Merger() const;
+};
@@ -1,8 +1,15 @@
 #include "tape.h"
 
-Tape::Tape(std::string const& file_name, TapeDelays const& delays)
-    : tape_file_(file_name, std::fstream::in | std::fstream::out | std::fstream::binary),
-      delays_(delays) {
+Tape::Tape(std::string const& file_name, TapeDelays const& delays, MemoryBudget* budget)
+    : buffer_(BudgetAllocator<char>(budget)), delays_(delays) {
+    if (budget != nullptr) {
+        if (budget->Available() >= kBufferSize) {
+            buffer_.resize(kBufferSize);
+        }
+        tape_file_.rdbuf()->pubsetbuf(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    }
+
+    tape_file_.open(file_name, std::fstream::in | std::fstream::out | std::fstream::binary);
     if (!tape_file_.is_open()) {
         throw std::runtime_error("Failed to open file: " + file_name);
     }
@@ -4,10 +4,15 @@
 #include <vector>
 
 #include "i_tape.h"
+#include "memory_budget.h"
 #include "tape_config.h"
 
 class Tape : public ITape {
+public:
+    static constexpr size_t kBufferSize = 8192;
+
 private:
+    BudgetVector<char> buffer_;
     std::fstream tape_file_;
     std::streampos current_position_ = 0;
     TapeDelays delays_;
@@ -16,7 +21,8 @@ private:
     std::streampos GetFileSize();
 
 public:
-    Tape(std::string const& file_name, TapeDelays const& delays);
+    // With a budget, the file buffer is drawn from it. The tape is unbuffered if it does not fit.
+    Tape(std::string const& file_name, TapeDelays const& delays, MemoryBudget* budget = nullptr);
 
     bool Read(int32_t& value) override;
     void Write(int32_t value) override;
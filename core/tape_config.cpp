@@ -6,15 +6,37 @@
 #include <stdexcept>
 
 namespace {
-constexpr std::array<char const*, 4> kValidKeys = {"read_delay", "write_delay", "rewind_delay",
+constexpr std::array<char const*, 4> kDelayKeys = {"read_delay", "write_delay", "rewind_delay",
                                                    "move_delay"};
+constexpr std::array<char const*, 7> kModelKeys = {
+        "start_delay_us",  "rewind_per_cell_ns", "throughput_mb_s", "jitter_percent",
+        "read_error_rate", "write_error_rate",   "seed"};
+
+uint64_t ParseUnsigned(std::string const& value) {
+    size_t pos = 0;
+    if (value.empty() || value.front() == '-') throw std::invalid_argument(value);
+    auto const result = std::stoull(value, &pos);
+    if (pos != value.size()) throw std::invalid_argument(value);
+    return result;
+}
+
+double ParseRate(std::string const& value) {
+    size_t pos = 0;
+    auto const result = std::stod(value, &pos);
+    if (pos != value.size() || !(result >= 0 && result <= 1)) throw std::out_of_range(value);
+    return result;
+}
 }  // namespace
 
 TapeDelays ConfigParser::Parse(std::string const& config_path) {
+    return ParseModel(config_path).delays;
+}
+
+TapeModel ConfigParser::ParseModel(std::string const& config_path) {
     std::ifstream file(config_path);
     if (!file) throw std::runtime_error("Config file not found: " + config_path);
 
-    TapeDelays delays;
+    TapeModel model;
     std::string line;
     int line_num = 0;
 
@@ -34,19 +56,27 @@ TapeDelays ConfigParser::Parse(std::string const& config_path) {
         }
 
         try {
-            auto ms_value = std::chrono::milliseconds(std::stoi(value));
-            SetDelay(delays, key, ms_value);
+            if (IsDelayKey(key)) {
+                SetDelay(model.delays, key, std::chrono::milliseconds(std::stoi(value)));
+            } else {
+                SetModelValue(model, key, value);
+            }
         } catch (...) {
             throw std::runtime_error("Invalid value for key: " + key + " on line " +
                                      std::to_string(line_num));
         }
     }
 
-    return delays;
+    return model;
 }
 
 constexpr bool ConfigParser::IsValidKey(std::string const& key) noexcept {
-    return std::ranges::any_of(kValidKeys, [&key](char const* valid) { return key == valid; });
+    return IsDelayKey(key) ||
+           std::ranges::any_of(kModelKeys, [&key](char const* valid) { return key == valid; });
+}
+
+constexpr bool ConfigParser::IsDelayKey(std::string const& key) noexcept {
+    return std::ranges::any_of(kDelayKeys, [&key](char const* valid) { return key == valid; });
 }
 
 void ConfigParser::SetDelay(TapeDelays& delays, std::string const& key,
@@ -56,3 +86,22 @@ void ConfigParser::SetDelay(TapeDelays& delays, std::string const& key,
     if (key == "rewind_delay") delays.rewind_delay_ms_ = value;
     if (key == "move_delay") delays.move_delay_ms_ = value;
 }
+
+void ConfigParser::SetModelValue(TapeModel& model, std::string const& key,
+                                 std::string const& value) {
+    if (key == "start_delay_us") {
+        model.start_delay = std::chrono::microseconds(ParseUnsigned(value));
+    }
+    if (key == "rewind_per_cell_ns") {
+        model.rewind_per_cell = std::chrono::nanoseconds(ParseUnsigned(value));
+    }
+    if (key == "throughput_mb_s") model.throughput_mb_s = ParseUnsigned(value);
+    if (key == "jitter_percent") {
+        auto const percent = ParseUnsigned(value);
+        if (percent > 100) throw std::out_of_range(value);
+        model.jitter_percent = static_cast<uint32_t>(percent);
+    }
+    if (key == "read_error_rate") model.read_error_rate = ParseRate(value);
+    if (key == "write_error_rate") model.write_error_rate = ParseRate(value);
+    if (key == "seed") model.seed = ParseUnsigned(value);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 
 struct TapeDelays {
@@ -19,12 +20,36 @@ struct TapeDelays {
           move_delay_ms_(move) {}
 };
 
+// Drive model of a SimulatedTape. Its costs are added up on a simulated clock instead of slept.
+struct TapeModel {
+    // Base cost of every operation.
+    TapeDelays delays;
+    // Added to a move that starts the head after a rewind or turns it around, so moves streaming
+    // in one direction are cheaper.
+    std::chrono::microseconds start_delay{0};
+    // Added to a rewind for every cell between the head and the beginning of the tape.
+    std::chrono::nanoseconds rewind_per_cell{0};
+    // Limits the transfer of a read or written cell, 0 for no limit.
+    uint64_t throughput_mb_s = 0;
+    // Every cost is scaled by a random factor within this many percent of 1.
+    uint32_t jitter_percent = 0;
+    // Probabilities of a read or write failing.
+    double read_error_rate = 0;
+    double write_error_rate = 0;
+    // Seed of the jitter and failures, so a simulation is repeatable.
+    uint64_t seed = 0;
+};
+
 class ConfigParser {
 public:
     static TapeDelays Parse(std::string const& config_path);
+    // Parses the delays along with the drive model keys in a single pass over the file.
+    static TapeModel ParseModel(std::string const& config_path);
 
 private:
     static constexpr bool IsValidKey(std::string const& key) noexcept;
+    static constexpr bool IsDelayKey(std::string const& key) noexcept;
     static void SetDelay(TapeDelays& delays, std::string const& key,
                          std::chrono::milliseconds const& value);
+    static void SetModelValue(TapeModel& model, std::string const& key, std::string const& value);
 };
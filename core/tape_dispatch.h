@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <ranges>
+#include <type_traits>
+#include <typeinfo>
+
+#include "i_tape.h"
+#include "memory_tape.h"
+#include "tape.h"
+
+// Calls the operations of a tape whose dynamic type is exactly T without virtual dispatch, so
+// they can be inlined into the loop using them.
+template <typename T>
+class TapeAccess {
+public:
+    explicit TapeAccess(ITape& tape) : tape_(static_cast<T&>(tape)) {}
+
+    bool Read(int32_t& value) const {
+        return tape_.T::Read(value);
+    }
+    void Write(int32_t const value) const {
+        tape_.T::Write(value);
+    }
+    void Move(MoveDirection const direction) const {
+        tape_.T::Move(direction);
+    }
+    void Rewind() const {
+        tape_.T::Rewind();
+    }
+
+private:
+    T& tape_;
+};
+
+// Any other tape, through its virtual functions.
+template <>
+class TapeAccess<ITape> {
+public:
+    explicit TapeAccess(ITape& tape) : tape_(tape) {}
+
+    bool Read(int32_t& value) const {
+        return tape_.Read(value);
+    }
+    void Write(int32_t const value) const {
+        tape_.Write(value);
+    }
+    void Move(MoveDirection const direction) const {
+        tape_.Move(direction);
+    }
+    void Rewind() const {
+        tape_.Rewind();
+    }
+
+private:
+    ITape& tape_;
+};
+
+template <typename... Tapes>
+struct TapeTypes {};
+
+// Tape types the sorter loops are instantiated for.
+using SpecializedTapes = TapeTypes<Tape, MemoryTape>;
+
+namespace tape_dispatch {
+template <typename Range, typename Visitor, typename First, typename... Rest>
+void VisitType(Range&& tapes, Visitor& visitor, TapeTypes<First, Rest...>) {
+    bool const all_first = std::ranges::all_of(
+            tapes, [](ITape const& tape) { return typeid(tape) == typeid(First); });
+    if (all_first) {
+        visitor(std::type_identity<First>{});
+    } else if constexpr (sizeof...(Rest) == 0) {
+        visitor(std::type_identity<ITape>{});
+    } else {
+        VisitType(tapes, visitor, TapeTypes<Rest...>{});
+    }
+}
+}  // namespace tape_dispatch
+
+// Calls visitor with std::type_identity of the specialized type that every tape of the range has,
+// or of ITape if they differ or have none. An empty range counts as the first specialized type.
+template <std::ranges::forward_range Range, typename Visitor>
+void VisitTapeType(Range&& tapes, Visitor&& visitor) {
+    tape_dispatch::VisitType(tapes, visitor, SpecializedTapes{});
+}
+
+// Calls visitor with a TapeAccess for the dynamic type of tape.
+template <typename Visitor>
+void VisitTape(ITape& tape, Visitor&& visitor) {
+    VisitTapeType(std::ranges::single_view<ITape*>(&tape) |
+                          std::views::transform([](ITape* tape) -> ITape& { return *tape; }),
+                  [&](auto type) { visitor(TapeAccess<typename decltype(type)::type>(tape)); });
+}
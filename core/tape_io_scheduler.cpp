@@ -0,0 +1,71 @@
+#include "tape_io_scheduler.h"
+
+#include <algorithm>
+
+TapeDrive::TapeDrive(size_t const queue_capacity)
+    : capacity_(std::max<size_t>(queue_capacity, 1)), thread_(&TapeDrive::Run, this) {}
+
+TapeDrive::~TapeDrive() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    not_empty_.notify_all();
+    thread_.join();
+}
+
+void TapeDrive::Post(std::function<void()> task) {
+    std::unique_lock lock(mutex_);
+    not_full_.wait(lock, [this] { return tasks_.size() < capacity_; });
+    tasks_.push_back(std::move(task));
+    lock.unlock();
+    not_empty_.notify_one();
+}
+
+void TapeDrive::Run() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex_);
+            not_empty_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        not_full_.notify_one();
+        task();
+    }
+}
+
+TapeIoScheduler::TapeIoScheduler(size_t const max_drives, size_t const queue_capacity)
+    : max_drives_(max_drives), queue_capacity_(queue_capacity) {}
+
+TapeDrive& TapeIoScheduler::Acquire() {
+    std::lock_guard lock(mutex_);
+    auto least_loaded = std::ranges::min_element(
+            drives_, {}, [](auto const& drive) { return drive->users_; });
+
+    bool const has_idle = least_loaded != drives_.end() && (*least_loaded)->users_ == 0;
+    bool const can_grow = max_drives_ == 0 || drives_.size() < max_drives_;
+    if (!has_idle && can_grow) {
+        drives_.push_back(std::make_unique<TapeDrive>(queue_capacity_));
+        least_loaded = std::prev(drives_.end());
+    }
+
+    ++(*least_loaded)->users_;
+    return **least_loaded;
+}
+
+void TapeIoScheduler::Release(TapeDrive& drive) {
+    std::lock_guard lock(mutex_);
+    if (drive.users_ > 0) {
+        --drive.users_;
+    }
+}
+
+size_t TapeIoScheduler::DriveCount() {
+    std::lock_guard lock(mutex_);
+    return drives_.size();
+}
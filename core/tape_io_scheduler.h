@@ -0,0 +1,68 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// A single I/O worker modeling one tape drive. Tasks posted to a drive are executed in FIFO order
+// on its own thread, so operations on different drives overlap in device time.
+class TapeDrive {
+public:
+    explicit TapeDrive(size_t queue_capacity);
+    ~TapeDrive();
+
+    TapeDrive(TapeDrive const&) = delete;
+    TapeDrive& operator=(TapeDrive const&) = delete;
+
+    // Blocks while the queue is full, which bounds the memory used by write-behind.
+    void Post(std::function<void()> task);
+
+    template <typename Function>
+    auto Submit(Function&& function) -> std::future<std::invoke_result_t<Function>> {
+        using Result = std::invoke_result_t<Function>;
+        auto task =
+                std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        auto future = task->get_future();
+        Post([task] { (*task)(); });
+        return future;
+    }
+
+private:
+    friend class TapeIoScheduler;
+
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<std::function<void()>> tasks_;
+    size_t capacity_;
+    bool stopping_ = false;
+    size_t users_ = 0;
+    std::thread thread_;
+
+    void Run();
+};
+
+// Assigns tapes to drives. Every tape gets a dedicated drive unless max_drives is reached, in which
+// case tapes share the least loaded drive.
+class TapeIoScheduler {
+public:
+    static constexpr size_t kDefaultQueueCapacity = 1024;
+
+    explicit TapeIoScheduler(size_t max_drives = 0, size_t queue_capacity = kDefaultQueueCapacity);
+
+    TapeDrive& Acquire();
+    void Release(TapeDrive& drive);
+
+    [[nodiscard]] size_t DriveCount();
+
+private:
+    size_t max_drives_;
+    size_t queue_capacity_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<TapeDrive>> drives_;
+};
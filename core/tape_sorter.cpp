@@ -1,81 +1,262 @@
 #include "tape_sorter.h"
 
 #include <algorithm>
-#include <queue>
+#include <limits>
+#include <ranges>
+#include <string>
 
-std::vector<std::unique_ptr<ITape>> TapeSorter::Split(ITape& input_tape) const {
-    std::vector<std::unique_ptr<ITape>> tmp_tapes;
-    input_tape.Rewind();
+#include "parallel_sort.h"
+#include "run_merger.h"
+#include "tape_dispatch.h"
+
+namespace {
+constexpr size_t kUnknownLength = std::numeric_limits<size_t>::max();
+constexpr size_t kNotInput = std::numeric_limits<size_t>::max();
+
+template <SequentialTape Access>
+class RunReader {
+public:
+    // An input run has unknown length and is read forward to its end, checking that it ascends.
+    RunReader(Access const tape, size_t const length, MoveDirection const direction,
+              size_t const input = kNotInput)
+        : tape_(tape), remaining_(length), input_(input), direction_(direction) {
+        if (direction_ == MoveDirection::kForward) {
+            tape_.Rewind();
+        }
+    }
+
+    bool Next(int32_t& value) {
+        if (remaining_ == 0) {
+            return false;
+        }
+        if (direction_ == MoveDirection::kBackward) {
+            tape_.Move(MoveDirection::kBackward);
+        }
+        if (!tape_.Read(value)) {
+            if (input_ != kNotInput) {
+                remaining_ = 0;
+                return false;
+            }
+            throw std::runtime_error("Temporary tape is shorter than its run");
+        }
+        if (direction_ == MoveDirection::kForward) {
+            tape_.Move(MoveDirection::kForward);
+        }
+        if (input_ != kNotInput) {
+            if (remaining_ != kUnknownLength && value < previous_) {
+                throw std::runtime_error("Input tape " + std::to_string(input_) +
+                                         " is not sorted at element " +
+                                         std::to_string(kUnknownLength - remaining_));
+            }
+            previous_ = value;
+        }
+        --remaining_;
+        return true;
+    }
+
+private:
+    Access tape_;
+    size_t remaining_;
+    size_t input_;
+    int32_t previous_ = 0;
+    MoveDirection direction_;
+};
+
+static_assert(sizeof(RunReader<TapeAccess<ITape>>) + sizeof(std::pair<int32_t, size_t>) <=
+              TapeSorter::kMergeBytesPerRun);
+}  // namespace
+
+size_t TapeSorter::CountPasses(size_t runs, size_t const max_fan_in, size_t const pinned) {
+    if (max_fan_in < 2) {
+        return 1;
+    }
+    size_t passes = 1;
+    while (runs > max_fan_in) {
+        runs = (runs - pinned + max_fan_in - 1) / max_fan_in + pinned;
+        ++passes;
+    }
+    return passes;
+}
+
+size_t TapeSorter::MaxBlockSize(size_t const memory_bytes) {
+    return (memory_bytes - memory_bytes / kHeadroomDivisor) / sizeof(int32_t);
+}
+
+RunMerger TapeSorter::Merger() const {
+    return {*factory_, options_, kMergeBytesPerRun};
+}
+
+std::vector<TapeSorter::Run> TapeSorter::Split(ITape& input_tape, size_t const pinned) const {
+    std::vector<Run> runs;
+    VisitTape(input_tape, [&](auto const input) { runs = SplitFrom(input, pinned); });
+    return runs;
+}
 
-    std::vector<int32_t> buffer;
-    buffer.reserve(memory_block_);
+template <SequentialTape Input>
+std::vector<TapeSorter::Run> TapeSorter::SplitFrom(Input const input_tape,
+                                                   size_t const pinned) const {
+    std::vector<Run> runs;
+    auto const merger = Merger();
+    size_t const block_size = merger.BlockSize(memory_block_, sizeof(int32_t));
+    bool const descending =
+            merger.StoreRunsDescending(options_.expected_elements, block_size, pinned);
+
+    BudgetVector<int32_t> buffer{BudgetAllocator<int32_t>(options_.memory_budget)};
+    buffer.reserve(block_size);
+
+    auto* progress = options_.progress;
+    if (progress != nullptr) {
+        progress->StartSplit();
+    }
 
     int32_t value;
     while (input_tape.Read(value)) {
         buffer.clear();
 
-        for (size_t i = 0; i < memory_block_ && input_tape.Read(value); ++i) {
+        for (size_t i = 0; i < block_size && input_tape.Read(value); ++i) {
             buffer.push_back(value);
             input_tape.Move(MoveDirection::kForward);
+            if (progress != nullptr) {
+                progress->AddSplit();
+            }
         }
 
-        std::sort(buffer.begin(), buffer.end());
+        if (descending) {
+            ParallelSort(buffer.begin(), buffer.end(), std::greater<>(), options_.sort_threads);
+        } else {
+            ParallelSort(buffer.begin(), buffer.end(), std::less<>(), options_.sort_threads);
+        }
         auto tmp_tape = factory_->Create();
-        for (auto const& val : buffer) {
-            tmp_tape->Write(val);
-            tmp_tape->Move(MoveDirection::kForward);
+        VisitTape(*tmp_tape, [&buffer](auto const run_tape) {
+            for (auto const& val : buffer) {
+                run_tape.Write(val);
+                run_tape.Move(MoveDirection::kForward);
+            }
+        });
+        runs.push_back({std::move(tmp_tape), buffer.size(), descending});
+        if (progress != nullptr) {
+            progress->AddRun();
         }
-        tmp_tape->Rewind();
-        tmp_tapes.push_back(std::move(tmp_tape));
     }
 
-    return tmp_tapes;
+    return runs;
+}
+
+size_t TapeSorter::MergePass(std::vector<Run>& runs, ITape& output_tape,
+                             bool const ascending) const {
+    size_t written = 0;
+    auto const sources =
+            runs | std::views::transform([](Run const& run) -> ITape& { return run.Source(); });
+    VisitTapeType(sources, [&](auto const source_type) {
+        using Source = typename decltype(source_type)::type;
+        VisitTape(output_tape, [&](auto const output) {
+            written = MergeRuns<Source>(runs, output, ascending);
+        });
+    });
+    return written;
 }
 
-void TapeSorter::Merge(std::vector<std::unique_ptr<ITape>> const& tmp_tapes, ITape& output_tape) {
+template <typename Source, SequentialTape Output>
+size_t TapeSorter::MergeRuns(std::vector<Run>& runs, Output const output_tape,
+                             bool const ascending) const {
     using Element = std::pair<int32_t, size_t>;
-    std::priority_queue<Element, std::vector<Element>, std::greater<>> heap;
+    auto const compare = [ascending](Element const& lhs, Element const& rhs) {
+        if (lhs.first != rhs.first) {
+            return ascending ? lhs.first > rhs.first : lhs.first < rhs.first;
+        }
+        return lhs.second > rhs.second;
+    };
 
-    for (auto& tape : tmp_tapes) {
-        tape->Rewind();
-    }
+    BudgetVector<Element> heap{BudgetAllocator<Element>(options_.memory_budget)};
+    heap.reserve(runs.size());
 
-    for (size_t idx = 0; idx < tmp_tapes.size(); ++idx) {
+    using Reader = RunReader<TapeAccess<Source>>;
+    BudgetVector<Reader> readers{BudgetAllocator<Reader>(options_.memory_budget)};
+    readers.reserve(runs.size());
+    for (size_t idx = 0; idx < runs.size(); ++idx) {
+        auto const& run = runs[idx];
+        bool const backward = options_.strategy == MergeStrategy::kReadBackward &&
+                              run.input == nullptr && run.descending == ascending;
+        readers.emplace_back(TapeAccess<Source>(run.Source()), run.length,
+                             backward ? MoveDirection::kBackward : MoveDirection::kForward,
+                             run.input != nullptr ? run.input_index : kNotInput);
         int32_t value;
-        if (tmp_tapes[idx]->Read(value)) {
-            heap.emplace(value, idx);
-            tmp_tapes[idx]->Move(MoveDirection::kForward);
+        if (readers[idx].Next(value)) {
+            heap.emplace_back(value, idx);
+            std::push_heap(heap.begin(), heap.end(), compare);
         }
     }
 
+    auto* progress = options_.progress;
+    size_t written = 0;
     while (!heap.empty()) {
-        auto [current_val, tape_idx] = heap.top();
-        heap.pop();
+        std::pop_heap(heap.begin(), heap.end(), compare);
+        auto [current_val, run_idx] = heap.back();
+        heap.pop_back();
 
         output_tape.Write(current_val);
         output_tape.Move(MoveDirection::kForward);
+        ++written;
+        if (progress != nullptr) {
+            progress->AddMerged();
+        }
 
         int32_t next_val;
-        if (tmp_tapes[tape_idx]->Read(next_val)) {
-            heap.emplace(next_val, tape_idx);
-            tmp_tapes[tape_idx]->Move(MoveDirection::kForward);
+        if (readers[run_idx].Next(next_val)) {
+            heap.emplace_back(next_val, run_idx);
+            std::push_heap(heap.begin(), heap.end(), compare);
         }
     }
+    return written;
+}
+
+void TapeSorter::Merge(std::vector<Run>& runs, ITape& output_tape, size_t const pinned) const {
+    auto const merge_pass = [this](std::vector<Run>& group, ITape& output, bool const ascending) {
+        return MergePass(group, output, ascending);
+    };
+    Merger().Merge(runs, output_tape, merge_pass, pinned);
+    FinishProgress();
+}
+
+void TapeSorter::FinishProgress() const {
+    if (auto* progress = options_.progress; progress != nullptr) {
+        progress->Finish();
+    }
 }
 
 void TapeSorter::Sort(ITape& input_tape, ITape& output_tape) const {
     input_tape.Rewind();
-    int32_t first_value;
-    if (!input_tape.Read(first_value)) {
+    auto runs = Split(input_tape);
+    if (runs.empty()) {
+        FinishProgress();
         return;
     }
 
+    output_tape.Rewind();
+    Merge(runs, output_tape);
+}
+
+void TapeSorter::SortIncremental(ITape& sorted_tape, ITape& input_tape,
+                                 ITape& output_tape) const {
     input_tape.Rewind();
-    auto tmp_tapes = Split(input_tape);
-    if (tmp_tapes.empty()) {
-        throw std::runtime_error("No temporary tapes created");
+    auto runs = Split(input_tape, 1);
+    runs.push_back({nullptr, kUnknownLength, false, &sorted_tape, 0});
+
+    output_tape.Rewind();
+    Merge(runs, output_tape, 1);
+}
+
+void TapeSorter::MergeSorted(std::vector<ITape*> const& input_tapes, ITape& output_tape) const {
+    std::vector<Run> runs;
+    runs.reserve(input_tapes.size());
+    for (size_t idx = 0; idx < input_tapes.size(); ++idx) {
+        runs.push_back({nullptr, kUnknownLength, false, input_tapes[idx], idx});
+    }
+    if (runs.empty()) {
+        FinishProgress();
+        return;
     }
 
     output_tape.Rewind();
-    Merge(tmp_tapes, output_tape);
+    Merge(runs, output_tape);
 }
@@ -1,20 +1,94 @@
 #pragma once
 #include <memory>
 
+#include "memory_budget.h"
+#include "sort_progress.h"
 #include "tmp_tape_factory.h"
 
+enum class MergeStrategy {
+    // Runs are read backward in the order opposite to the one they were written in, so merge
+    // passes alternate direction and temp tapes are never rewound.
+    kReadBackward,
+    // Runs are rewound and read forward before every merge pass.
+    kRewind,
+};
+
+struct SortOptions {
+    // Maximum number of runs merged at once, 0 merges all runs in a single pass.
+    size_t max_fan_in = 0;
+    // Expected input size, used to order runs so that the final pass does not rewind. 0 if unknown.
+    size_t expected_elements = 0;
+    MergeStrategy strategy = MergeStrategy::kReadBackward;
+    // Budget the split buffer and merge structures are drawn from. Block size and fan-in shrink to
+    // fit what is available. Not owned, nullptr if unlimited.
+    MemoryBudget* memory_budget = nullptr;
+    // Counters updated as the sort advances. Not owned, nullptr if not reported.
+    SortProgress* progress = nullptr;
+    // Threads sorting a block in memory. Blocks smaller than kParallelSortMinElements are sorted
+    // by a single thread.
+    size_t sort_threads = 1;
+};
+
+class RunMerger;
+
 class TapeSorter {
 public:
-    TapeSorter(size_t const memory_block, std::unique_ptr<ITapeFactory> factory)
-        : memory_block_(memory_block), factory_(std::move(factory)) {}
+    TapeSorter(size_t const memory_block, std::unique_ptr<ITapeFactory> factory,
+               SortOptions const& options = {})
+        : memory_block_(memory_block), factory_(std::move(factory)), options_(options) {}
+
+    // Bytes a merge needs for every run it reads.
+    static constexpr size_t kMergeBytesPerRun = 48;
+    // Part of the budget left for tape buffers and merge structures while splitting.
+    static constexpr size_t kHeadroomDivisor = 8;
 
     void Sort(ITape& input_tape, ITape& output_tape) const;
 
+    // Sorts input_tape and merges it with sorted_tape, the output of an earlier sort, so only the
+    // new elements are split. sorted_tape is read forward once and only in the final pass.
+    void SortIncremental(ITape& sorted_tape, ITape& input_tape, ITape& output_tape) const;
+
+    // Merges tapes that are already sorted in ascending order without splitting them. Inputs are
+    // rewound, read forward once and checked for order while they are merged.
+    void MergeSorted(std::vector<ITape*> const& input_tapes, ITape& output_tape) const;
+
+    // The last `pinned` runs take part in every pass but are merged only in the final one.
+    static size_t CountPasses(size_t runs, size_t max_fan_in, size_t pinned = 0);
+    static size_t MaxBlockSize(size_t memory_bytes);
+
 private:
+    // A sorted run. The head is left after the last element, so a run can be read backward, in
+    // the order opposite to the stored one, without rewinding the tape.
+    struct Run {
+        std::unique_ptr<ITape> tape;
+        size_t length;
+        bool descending;
+        // Caller's sorted input merged in place of a temp tape. Not owned.
+        ITape* input = nullptr;
+        size_t input_index = 0;
+
+        [[nodiscard]] ITape& Source() const {
+            return input != nullptr ? *input : *tape;
+        }
+    };
+
     size_t memory_block_;
     std::unique_ptr<ITapeFactory> factory_;
+    SortOptions options_;
+
+    // The last `pinned` runs are kept out of intermediate passes and merged only in the final one.
+    void Merge(std::vector<Run>& runs, ITape& output_tape, size_t pinned = 0) const;
+
+    // Dispatch to the loops below, instantiated for the concrete types of the tapes involved.
+    size_t MergePass(std::vector<Run>& runs, ITape& output_tape, bool ascending) const;
+    std::vector<Run> Split(ITape& input_tape, size_t pinned = 0) const;
+
+    template <typename Source, SequentialTape Output>
+    size_t MergeRuns(std::vector<Run>& runs, Output output_tape, bool ascending) const;
 
-    static void Merge(std::vector<std::unique_ptr<ITape>> const& tmp_tapes, ITape& output_tape);
+    template <SequentialTape Input>
+    std::vector<Run> SplitFrom(Input input_tape, size_t pinned) const;
 
-    std::vector<std::unique_ptr<ITape>> Split(ITape& input_tape) const;
+    [[nodiscard]] RunMerger Merger() const;
+    void FinishProgress() const;
 };
@@ -0,0 +1,237 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class Task;
+
+namespace detail {
+class PromiseBase {
+public:
+    struct FinalAwaiter {
+        static bool await_ready() noexcept {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            auto continuation = handle.promise().continuation_;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        static void await_resume() noexcept {}
+    };
+
+    static std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    static FinalAwaiter final_suspend() noexcept {
+        return {};
+    }
+
+    void unhandled_exception() noexcept {
+        exception_ = std::current_exception();
+    }
+
+    void SetContinuation(std::coroutine_handle<> continuation) noexcept {
+        continuation_ = continuation;
+    }
+
+protected:
+    std::coroutine_handle<> continuation_;
+    std::exception_ptr exception_;
+
+    void RethrowIfFailed() const {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+};
+
+template <typename T>
+class Promise : public PromiseBase {
+public:
+    Task<T> get_return_object() noexcept;
+
+    void return_value(T value) {
+        value_ = std::move(value);
+    }
+
+    T Result() {
+        RethrowIfFailed();
+        return std::move(*value_);
+    }
+
+private:
+    std::optional<T> value_;
+};
+
+template <>
+class Promise<void> : public PromiseBase {
+public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void Result() const {
+        RethrowIfFailed();
+    }
+};
+}  // namespace detail
+
+// Lazily started coroutine. Awaiting a task starts it and resumes the awaiting coroutine once the
+// task completes; top-level tasks are driven by EventLoop::Run.
+template <typename T = void>
+class Task {
+public:
+    using promise_type = detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle handle) noexcept : handle_(handle) {}
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            Destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    Task(Task const&) = delete;
+    Task& operator=(Task const&) = delete;
+
+    ~Task() {
+        Destroy();
+    }
+
+    [[nodiscard]] bool IsDone() const noexcept {
+        return handle_ && handle_.done();
+    }
+
+    [[nodiscard]] Handle GetHandle() const noexcept {
+        return handle_;
+    }
+
+    T Result() {
+        if (!IsDone()) {
+            throw std::logic_error("Task has not completed");
+        }
+        return handle_.promise().Result();
+    }
+
+    bool await_ready() const noexcept {
+        return !handle_ || handle_.done();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+        handle_.promise().SetContinuation(continuation);
+        return handle_;
+    }
+
+    T await_resume() {
+        return handle_.promise().Result();
+    }
+
+private:
+    Handle handle_;
+
+    void Destroy() noexcept {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+};
+
+namespace detail {
+template <typename T>
+Task<T> Promise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+// Fire-and-forget coroutine frame used to run a child of WhenAll; destroys itself on completion.
+struct Detached {
+    struct promise_type {
+        static Detached get_return_object() noexcept {
+            return {};
+        }
+
+        static std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+
+        static std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+
+        static void return_void() noexcept {}
+
+        static void unhandled_exception() noexcept {
+            std::terminate();
+        }
+    };
+};
+
+struct WhenAllState {
+    size_t remaining = 0;
+    std::coroutine_handle<> parent;
+    std::exception_ptr exception;
+};
+
+inline Detached RunChild(Task<void>& task, WhenAllState& state) {
+    try {
+        co_await task;
+    } catch (...) {
+        if (!state.exception) {
+            state.exception = std::current_exception();
+        }
+    }
+    if (--state.remaining == 0) {
+        state.parent.resume();
+    }
+}
+
+class WhenAllAwaiter {
+public:
+    explicit WhenAllAwaiter(std::vector<Task<void>>& tasks) : tasks_(tasks) {}
+
+    bool await_ready() const noexcept {
+        return tasks_.empty();
+    }
+
+    bool await_suspend(std::coroutine_handle<> parent) {
+        state_.parent = parent;
+        state_.remaining = tasks_.size() + 1;
+        for (auto& task : tasks_) {
+            RunChild(task, state_);
+        }
+        return --state_.remaining != 0;
+    }
+
+    void await_resume() const {
+        if (state_.exception) {
+            std::rethrow_exception(state_.exception);
+        }
+    }
+
+private:
+    std::vector<Task<void>>& tasks_;
+    WhenAllState state_;
+};
+}  // namespace detail
+
+// Runs the tasks concurrently and completes once all of them have finished. The first exception
+// thrown by any of the tasks is rethrown.
+inline Task<void> WhenAll(std::vector<Task<void>> tasks) {
+    co_await detail::WhenAllAwaiter(tasks);
+}
@@ -2,17 +2,55 @@
 
 #include <filesystem>
 #include <iostream>
+#include <stdexcept>
+#include <system_error>
 #include <utility>
 
 #include "tape.h"
+#ifdef TAPE_SORTER_HAS_DIRECT_IO
+#include "direct_tape.h"
+#endif
+#ifdef TAPE_SORTER_HAS_IO_ENGINE
+#include "io_engine_tape.h"
+#endif
 
-TmpTapeFactory::TmpTapeFactory(std::string dir_name, TapeDelays const &delays)
-    : dir_name_(std::move(dir_name)), delays_(delays) {
-    std::filesystem::create_directories(dir_name_);
+TmpTapeFactory::TmpTapeFactory(std::string dir_name, TapeDelays const &delays,
+                               MemoryBudget *budget, TapeBackend const backend)
+    : TmpTapeFactory(std::vector<std::string>{std::move(dir_name)}, delays, budget, backend) {
+}
+
+TmpTapeFactory::TmpTapeFactory(std::vector<std::string> dir_names, TapeDelays const &delays,
+                               MemoryBudget *budget, TapeBackend const backend,
+                               TapePlacement const placement)
+    : dir_names_(std::move(dir_names)),
+      delays_(delays),
+      budget_(budget),
+      backend_(backend),
+      placement_(placement) {
+    if (dir_names_.empty()) {
+        throw std::invalid_argument("At least one temp directory is required");
+    }
+#ifndef TAPE_SORTER_HAS_DIRECT_IO
+    if (backend_ == TapeBackend::kDirect) {
+        throw std::runtime_error("Direct I/O tapes are not supported on this platform");
+    }
+#endif
+#ifdef TAPE_SORTER_HAS_IO_ENGINE
+    if (backend_ == TapeBackend::kIoEngine) {
+        engine_ = IoEngine::Create();
+    }
+#else
+    if (backend_ == TapeBackend::kIoEngine) {
+        throw std::runtime_error("I/O engine tapes are not supported on this platform");
+    }
+#endif
+    for (auto const &dir_name : dir_names_) {
+        std::filesystem::create_directories(dir_name);
+    }
 }
 
 std::unique_ptr<ITape> TmpTapeFactory::Create() {
-    std::string tape_name = GenerateTapeName();
+    std::string tape_name = GenerateTapeName(NextDirectory());
     std::ofstream file(tape_name);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to create file: " + tape_name);
@@ -20,7 +58,22 @@ std::unique_ptr<ITape> TmpTapeFactory::Create() {
     file.close();
 
     created_tapes_.push_back(tape_name);
-    return std::make_unique<Tape>(tape_name, delays_);
+#ifdef TAPE_SORTER_HAS_DIRECT_IO
+    if (backend_ == TapeBackend::kDirect && BudgetHolds(DirectTape::kAlignment)) {
+        return std::make_unique<DirectTape>(tape_name, delays_, budget_);
+    }
+#endif
+#ifdef TAPE_SORTER_HAS_IO_ENGINE
+    if (backend_ == TapeBackend::kIoEngine &&
+        BudgetHolds(IoEngineTape::kSlots * IoEngineTape::kAlignment)) {
+        return std::make_unique<IoEngineTape>(tape_name, delays_, engine_, budget_);
+    }
+#endif
+    return std::make_unique<Tape>(tape_name, delays_, budget_);
+}
+
+bool TmpTapeFactory::BudgetHolds(size_t const bytes) const {
+    return budget_ == nullptr || budget_->Available() >= bytes;
 }
 
 void TmpTapeFactory::CleanupTempFiles() const {
@@ -33,9 +86,27 @@ void TmpTapeFactory::CleanupTempFiles() const {
     }
 }
 
-std::string TmpTapeFactory::GenerateTapeName() const {
+std::string const &TmpTapeFactory::NextDirectory() {
+    size_t chosen = next_dir_;
+    if (placement_ == TapePlacement::kFreeSpace) {
+        std::uintmax_t most_available = 0;
+        for (size_t offset = 0; offset < dir_names_.size(); ++offset) {
+            size_t const idx = (next_dir_ + offset) % dir_names_.size();
+            std::error_code error;
+            auto const space = std::filesystem::space(dir_names_[idx], error);
+            if (!error && space.available > most_available) {
+                most_available = space.available;
+                chosen = idx;
+            }
+        }
+    }
+    next_dir_ = (chosen + 1) % dir_names_.size();
+    return dir_names_[chosen];
+}
+
+std::string TmpTapeFactory::GenerateTapeName(std::string const &dir_name) {
     static int tape_counter = 0;
-    return dir_name_ + "/tmp_tape" + std::to_string(tape_counter++);
+    return dir_name + "/tmp_tape" + std::to_string(tape_counter++);
 }
 
 TmpTapeFactory::~TmpTapeFactory() {
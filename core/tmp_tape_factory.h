@@ -1,8 +1,14 @@
 #pragma once
 #include <memory>
+#include <string>
 #include <vector>
 
+#ifdef TAPE_SORTER_HAS_IO_ENGINE
+#include "io_engine.h"
+#endif
+
 #include "i_tape.h"
+#include "memory_budget.h"
 #include "tape_config.h"
 
 class ITapeFactory {
@@ -11,9 +17,34 @@ public:
     virtual std::unique_ptr<ITape> Create() = 0;
 };
 
+enum class TapeBackend {
+    // Buffered fstream, see Tape.
+    kStream,
+    // Page cache bypassing block I/O, see DirectTape. Only available with
+    // TAPE_SORTER_HAS_DIRECT_IO. Tapes created once the budget cannot hold an aligned block are
+    // kStream tapes.
+    kDirect,
+    // Block I/O with readahead and write-behind through a shared IoEngine, see IoEngineTape. Only
+    // available with TAPE_SORTER_HAS_IO_ENGINE. Tapes created once the budget cannot hold the
+    // aligned block slots are kStream tapes.
+    kIoEngine,
+};
+
+// How temp tapes are spread over several scratch directories.
+enum class TapePlacement {
+    // Directories in turn, so consecutive runs land on different devices.
+    kRoundRobin,
+    // The directory with the most available space at the time the tape is created.
+    kFreeSpace,
+};
+
 class TmpTapeFactory : public ITapeFactory {
 public:
-    TmpTapeFactory(std::string dir_name, TapeDelays const& delays);
+    TmpTapeFactory(std::string dir_name, TapeDelays const& delays, MemoryBudget* budget = nullptr,
+                   TapeBackend backend = TapeBackend::kStream);
+    TmpTapeFactory(std::vector<std::string> dir_names, TapeDelays const& delays,
+                   MemoryBudget* budget = nullptr, TapeBackend backend = TapeBackend::kStream,
+                   TapePlacement placement = TapePlacement::kRoundRobin);
 
     std::unique_ptr<ITape> Create() override;
     ~TmpTapeFactory() override;
@@ -22,9 +53,18 @@ protected:
     void CleanupTempFiles() const;
 
 private:
-    std::string dir_name_;
+    std::vector<std::string> dir_names_;
     TapeDelays delays_;
+    MemoryBudget* budget_;
+    TapeBackend backend_;
+    TapePlacement placement_;
+    size_t next_dir_ = 0;
     std::vector<std::string> created_tapes_;
+#ifdef TAPE_SORTER_HAS_IO_ENGINE
+    std::shared_ptr<IoEngine> engine_;
+#endif
 
-    std::string GenerateTapeName() const;
+    [[nodiscard]] bool BudgetHolds(size_t bytes) const;
+    std::string const& NextDirectory();
+    static std::string GenerateTapeName(std::string const& dir_name);
 };
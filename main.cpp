@@ -1,17 +1,63 @@
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "checksum.h"
+#include "checksum_tape.h"
+#include "record_sorter.h"
+#include "scheduled_tape.h"
+#ifdef TAPE_SORTER_HAS_SHARDS
+#include "sharded_sorter.h"
+#endif
+#include "simulated_tape.h"
+#include "sort_planner.h"
+#include "sort_progress.h"
+#include "stream_tape.h"
+#include "string_sorter.h"
 #include "tape.h"
 #include "tape_config.h"
 #include "tape_sorter.h"
 #include "tmp_tape_factory.h"
 
-constexpr size_t kDefaultBlockSize = 32;
+constexpr size_t kDefaultMemoryBudget = size_t{64} * 1024 * 1024;
+// Input or output path standing for standard input or output.
+constexpr char const* kStdStream = "-";
 
-void ConvertTextToBinary(std::string const& text_path, std::string const& binary_path) {
+size_t ParseByteSize(std::string const& text) {
+    size_t parsed = 0;
+    size_t const value = std::stoull(text, &parsed);
+
+    std::string suffix = text.substr(parsed);
+    if (!suffix.empty() && (suffix.back() == 'B' || suffix.back() == 'b')) {
+        suffix.pop_back();
+    }
+
+    size_t multiplier = 1;
+    if (suffix == "K" || suffix == "k") {
+        multiplier = size_t{1} << 10;
+    } else if (suffix == "M" || suffix == "m") {
+        multiplier = size_t{1} << 20;
+    } else if (suffix == "G" || suffix == "g") {
+        multiplier = size_t{1} << 30;
+    } else if (!suffix.empty()) {
+        throw std::runtime_error("Invalid size: " + text);
+    }
+    return value * multiplier;
+}
+
+void ConvertTextToBinary(std::string const& text_path, std::string const& binary_path,
+                         SortVerifier* verifier = nullptr) {
     std::ifstream input(text_path);
     if (!input) {
         throw std::runtime_error("Cannot open input text file: " + text_path);
@@ -25,49 +71,245 @@ void ConvertTextToBinary(std::string const& text_path, std::string const& binary
     int32_t value;
     while (input >> value) {
         output.write(reinterpret_cast<char const*>(&value), sizeof(value));
+        if (verifier != nullptr) {
+            verifier->AddInput(value);
+        }
     }
 }
 
-void ConvertBinaryToText(std::string const& binary_path, std::string const& text_path) {
-    std::ifstream input(binary_path, std::ios::binary);
+// Writes every line of a text file as a string record: the key runs up to the first tab, the
+// payload is the rest of the line, tab included. Returns the number of records.
+size_t ConvertLinesToRecords(std::string const& text_path, std::string const& records_path) {
+    std::ifstream input(text_path);
     if (!input) {
-        throw std::runtime_error("Cannot open binary file: " + binary_path);
+        throw std::runtime_error("Cannot open input text file: " + text_path);
+    }
+    if (!std::ofstream(records_path)) {
+        throw std::runtime_error("Cannot create record file: " + records_path);
     }
 
-    std::ofstream output(text_path);
-    if (!output) {
-        throw std::runtime_error("Cannot create output text file: " + text_path);
+    Tape output(records_path, TapeDelays());
+    size_t count = 0;
+    std::string line;
+    while (std::getline(input, line)) {
+        std::string_view const text = line;
+        size_t const tab = std::min(text.find('\t'), text.size());
+        WriteStringRecord(output, text.substr(0, tab), text.substr(tab));
+        ++count;
+    }
+    return count;
+}
+
+// Writes every record of a string record tape as a line, its key followed by its payload.
+void WriteRecordLines(ITape& tape, std::FILE* file) {
+    constexpr size_t kChunkBytes = size_t{1} << 20;
+    std::string chunk;
+    auto const drain = [&chunk, file] {
+        if (std::fwrite(chunk.data(), 1, chunk.size(), file) != chunk.size()) {
+            throw std::runtime_error("Failed to write output");
+        }
+        chunk.clear();
+    };
+
+    tape.Rewind();
+    StringRecord record;
+    while (ReadStringRecord(tape, record)) {
+        chunk += record.key;
+        chunk += record.payload;
+        chunk += '\n';
+        if (chunk.size() >= kChunkBytes) {
+            drain();
+        }
+    }
+    drain();
+}
+
+// Output file written under a temporary name beside its path and renamed into place by Commit,
+// so that a failed sort leaves no partial output and the output may replace one of the inputs.
+class OutputFile {
+public:
+    OutputFile(std::string path, bool const binary)
+        : path_(std::move(path)),
+          part_path_(path_ + ".part"),
+          file_(std::fopen(part_path_.c_str(), binary ? "wb" : "w")) {
+        if (file_ == nullptr) {
+            throw std::runtime_error("Cannot create output file: " + path_);
+        }
+    }
+
+    ~OutputFile() {
+        if (file_ != nullptr) {
+            std::fclose(file_);
+        }
+        if (!committed_) {
+            std::error_code error;
+            std::filesystem::remove(part_path_, error);
+        }
+    }
+
+    OutputFile(OutputFile const&) = delete;
+    OutputFile& operator=(OutputFile const&) = delete;
+
+    [[nodiscard]] std::FILE* Get() const {
+        return file_;
+    }
+
+    void Commit() {
+        if (std::fclose(std::exchange(file_, nullptr)) != 0) {
+            throw std::runtime_error("Failed to close output file: " + path_);
+        }
+        std::filesystem::rename(part_path_, path_);
+        committed_ = true;
+    }
+
+private:
+    std::string path_;
+    std::string part_path_;
+    std::FILE* file_;
+    bool committed_ = false;
+};
+
+void AddBinaryInput(std::string const& binary_path, SortVerifier& verifier) {
+    std::ifstream input(binary_path, std::ios::binary);
+    if (!input) {
+        throw std::runtime_error("Cannot open input binary file: " + binary_path);
     }
 
     int32_t value;
     while (input.read(reinterpret_cast<char*>(&value), sizeof(value))) {
-        output << value << std::endl;
+        verifier.AddInput(value);
     }
 }
 
+void PrintProgress(ProgressSnapshot const& snapshot) {
+    std::ostringstream line;
+    switch (snapshot.phase) {
+        case SortPhase::kSplit:
+            line << "split: " << snapshot.elements_split << " elements, " << snapshot.runs_written
+                 << " runs";
+            break;
+        case SortPhase::kMerge:
+            line << "merge pass " << snapshot.merge_pass << "/" << snapshot.merge_passes << ": "
+                 << snapshot.elements_merged << " elements";
+            break;
+        case SortPhase::kDone:
+            line << "done";
+            break;
+    }
+
+    line << std::fixed << std::setprecision(1);
+    if (auto const fraction = snapshot.Fraction()) {
+        line << ", " << *fraction * 100 << "%";
+    }
+    line << ", " << snapshot.Throughput() << " elements/s, elapsed " << snapshot.elapsed.count()
+         << "s";
+    if (auto const eta = snapshot.Eta(); eta && snapshot.phase != SortPhase::kDone) {
+        line << ", ETA " << eta->count() << "s";
+    }
+    std::cerr << line.str() << std::endl;
+}
+
+void PrintSimulation(SimulationStats const& stats) {
+    std::cerr << std::fixed << std::setprecision(3) << "Simulated tape time: "
+              << std::chrono::duration<double>(stats.Elapsed()).count() << "s (" << stats.reads
+              << " reads, " << stats.writes << " writes, " << stats.moves << " moves, "
+              << stats.turnarounds << " turnarounds, " << stats.rewinds << " rewinds, "
+              << stats.faults << " faults, " << stats.retries << " retries)" << std::endl;
+}
+
 void PrintHelp() {
     std::cout << "Options:" << std::endl;
     std::cout << "  -h, --help                Show this help message" << std::endl;
-    std::cout << "  -i, --input FILE          Input tape file (required)" << std::endl;
-    std::cout << "  -o, --output FILE         Output tape file (required)" << std::endl;
+    std::cout << "  -i, --input FILE          Input tape file, - for stdin (required, repeat with "
+                 "--merge-only)"
+              << std::endl;
+    std::cout << "  -o, --output FILE         Output tape file, - for stdout (required)"
+              << std::endl;
     std::cout << "  -c, --config FILE         Configuration file (default is 0 on all operations)"
               << std::endl;
-    std::cout << "  -b, --block-size SIZE     Memory block size (default: " << kDefaultBlockSize
-              << ")" << std::endl;
+    std::cout << "  -m, --memory BYTES        Memory budget, K/M/G suffixes allowed (default: "
+              << kDefaultMemoryBudget / (size_t{1} << 20) << "M)" << std::endl;
+    std::cout << "  -b, --block-size SIZE     Memory block size (default: chosen by the planner)"
+              << std::endl;
+    std::cout << "  -t, --tapes COUNT         Tapes available to a merge pass (default: unlimited)"
+              << std::endl;
+    std::cout << "      --sort-threads COUNT  Threads sorting a large block (default: all cores)"
+              << std::endl;
+    std::cout << "  -e, --explain             Print the sort plan and exit" << std::endl;
+    std::cout << "  -p, --parallel-io         Run every tape on its own I/O worker" << std::endl;
+    std::cout << "      --merge-only          Merge already sorted inputs without splitting"
+              << std::endl;
+    std::cout << "      --records             Stable sort of key and payload pairs by key"
+              << std::endl;
+    std::cout << "      --strings             Stable sort of text lines by the key before a tab"
+              << std::endl;
+#ifdef TAPE_SORTER_HAS_DIRECT_IO
+    std::cout << "      --direct-io           Keep temp tapes out of the page cache" << std::endl;
+#endif
+#ifdef TAPE_SORTER_HAS_IO_ENGINE
+    std::cout << "      --io-uring            Prefetch and write back temp tapes with io_uring"
+              << std::endl;
+#endif
+    std::cout << "      --tmp-dir DIR         Scratch directory for temp tapes, can be repeated"
+              << std::endl;
+    std::cout << "      --tmp-placement MODE  round-robin or free-space (default: round-robin)"
+              << std::endl;
+    std::cout << "      --binary              Input and output hold native int32 cells, not text"
+              << std::endl;
+    std::cout << "      --progress            Print progress and ETA every second" << std::endl;
+    std::cout << "      --verify              Checksum temp tapes and check the output"
+              << std::endl;
+    std::cout << "      --simulate            Time tape operations by the drive model of the config"
+              << std::endl;
+    std::cout << "      --retries COUNT       Retry a failed simulated read or write (default: 0)"
+              << std::endl;
+    std::cout << "      --base FILE           Earlier sorted output to merge the input into"
+              << std::endl;
+#ifdef TAPE_SORTER_HAS_SHARDS
+    std::cout << "  -s, --shards COUNT        Range-partition the sort across worker processes"
+              << std::endl;
+#endif
     std::cout << std::endl;
     std::cout << "Configuration file format:" << std::endl;
     std::cout << "  read_delay=<milliseconds>" << std::endl;
     std::cout << "  write_delay=<milliseconds>" << std::endl;
     std::cout << "  rewind_delay=<milliseconds>" << std::endl;
     std::cout << "  move_delay=<milliseconds>" << std::endl;
+    std::cout << "Drive model keys, used with --simulate:" << std::endl;
+    std::cout << "  start_delay_us=<microseconds>" << std::endl;
+    std::cout << "  rewind_per_cell_ns=<nanoseconds>" << std::endl;
+    std::cout << "  throughput_mb_s=<megabytes per second>" << std::endl;
+    std::cout << "  jitter_percent=<0-100>" << std::endl;
+    std::cout << "  read_error_rate=<0-1>" << std::endl;
+    std::cout << "  write_error_rate=<0-1>" << std::endl;
+    std::cout << "  seed=<number>" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
     try {
-        std::string input_text_path;
+        std::vector<std::string> input_text_paths;
         std::string output_text_path;
+        std::string base_text_path;
         TapeDelays delays;
-        size_t block_size = kDefaultBlockSize;
+        TapeModel model;
+        size_t block_size = 0;
+        size_t memory_budget = kDefaultMemoryBudget;
+        size_t max_tapes = 0;
+        size_t shards = 1;
+        size_t sort_threads = std::max(std::thread::hardware_concurrency(), 1U);
+        bool parallel_io = false;
+        bool explain = false;
+        bool merge_only = false;
+        bool records = false;
+        bool strings = false;
+        bool verify = false;
+        bool show_progress = false;
+        bool binary = false;
+        bool simulate = false;
+        size_t retries = 0;
+        TapeBackend backend = TapeBackend::kStream;
+        std::vector<std::string> temp_dirs;
+        TapePlacement placement = TapePlacement::kRoundRobin;
 
         if (argc == 1) {
             PrintHelp();
@@ -83,7 +325,7 @@ int main(int argc, char* argv[]) {
             }
             if (arg == "-i" || arg == "--input") {
                 if (i + 1 < argc) {
-                    input_text_path = argv[++i];
+                    input_text_paths.emplace_back(argv[++i]);
                 } else {
                     throw std::runtime_error("Missing input file path");
                 }
@@ -96,7 +338,8 @@ int main(int argc, char* argv[]) {
             } else if (arg == "-c" || arg == "--config") {
                 if (i + 1 < argc) {
                     std::string config_path = argv[++i];
-                    delays = ConfigParser::Parse(config_path);
+                    model = ConfigParser::ParseModel(config_path);
+                    delays = model.delays;
                 } else {
                     throw std::runtime_error("Missing config file path");
                 }
@@ -109,43 +352,358 @@ int main(int argc, char* argv[]) {
                 } else {
                     throw std::runtime_error("Missing block size value");
                 }
+            } else if (arg == "-m" || arg == "--memory") {
+                if (i + 1 < argc) {
+                    memory_budget = ParseByteSize(argv[++i]);
+                    if (memory_budget < 2 * TapeSorter::kMergeBytesPerRun) {
+                        throw std::runtime_error(
+                                "Memory budget must be at least " +
+                                std::to_string(2 * TapeSorter::kMergeBytesPerRun) + " bytes");
+                    }
+                } else {
+                    throw std::runtime_error("Missing memory budget value");
+                }
+            } else if (arg == "-t" || arg == "--tapes") {
+                if (i + 1 < argc) {
+                    max_tapes = std::stoull(argv[++i]);
+                    if (max_tapes < 3) {
+                        throw std::runtime_error("At least 3 tapes are required");
+                    }
+                } else {
+                    throw std::runtime_error("Missing tape count value");
+                }
+            } else if (arg == "--sort-threads") {
+                if (i + 1 < argc) {
+                    sort_threads = std::max<size_t>(std::stoull(argv[++i]), 1);
+                } else {
+                    throw std::runtime_error("Missing sort thread count value");
+                }
+            } else if (arg == "-e" || arg == "--explain") {
+                explain = true;
+            } else if (arg == "-p" || arg == "--parallel-io") {
+                parallel_io = true;
+            } else if (arg == "--merge-only") {
+                merge_only = true;
+#ifdef TAPE_SORTER_HAS_DIRECT_IO
+            } else if (arg == "--direct-io") {
+                backend = TapeBackend::kDirect;
+#endif
+#ifdef TAPE_SORTER_HAS_IO_ENGINE
+            } else if (arg == "--io-uring") {
+                backend = TapeBackend::kIoEngine;
+#endif
+            } else if (arg == "--tmp-dir") {
+                if (i + 1 < argc) {
+                    temp_dirs.emplace_back(argv[++i]);
+                } else {
+                    throw std::runtime_error("Missing temp directory path");
+                }
+            } else if (arg == "--tmp-placement") {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("Missing temp placement value");
+                }
+                std::string const value = argv[++i];
+                if (value == "round-robin") {
+                    placement = TapePlacement::kRoundRobin;
+                } else if (value == "free-space") {
+                    placement = TapePlacement::kFreeSpace;
+                } else {
+                    throw std::runtime_error("Temp placement must be round-robin or free-space");
+                }
+            } else if (arg == "--binary") {
+                binary = true;
+            } else if (arg == "--progress") {
+                show_progress = true;
+            } else if (arg == "--verify") {
+                verify = true;
+            } else if (arg == "--simulate") {
+                simulate = true;
+            } else if (arg == "--retries") {
+                if (i + 1 < argc) {
+                    retries = std::stoull(argv[++i]);
+                } else {
+                    throw std::runtime_error("Missing retry count value");
+                }
+            } else if (arg == "--records") {
+                records = true;
+            } else if (arg == "--strings") {
+                strings = true;
+            } else if (arg == "--base") {
+                if (i + 1 < argc) {
+                    base_text_path = argv[++i];
+                } else {
+                    throw std::runtime_error("Missing base file path");
+                }
+#ifdef TAPE_SORTER_HAS_SHARDS
+            } else if (arg == "-s" || arg == "--shards") {
+                if (i + 1 < argc) {
+                    shards = std::stoull(argv[++i]);
+                    if (shards == 0) {
+                        throw std::runtime_error("Shard count must be greater than zero");
+                    }
+                } else {
+                    throw std::runtime_error("Missing shard count value");
+                }
+#endif
             } else {
                 throw std::runtime_error("Unknown option: " + arg);
             }
         }
 
-        if (input_text_path.empty()) {
+        if (input_text_paths.empty()) {
             throw std::runtime_error("Input file path is required (use -i or --input)");
         }
+        if (input_text_paths.size() > 1 && !merge_only) {
+            throw std::runtime_error("Multiple input files require --merge-only");
+        }
+        if (merge_only && shards > 1) {
+            throw std::runtime_error("--merge-only cannot be combined with --shards");
+        }
+        if (!base_text_path.empty() && (merge_only || shards > 1)) {
+            throw std::runtime_error("--base cannot be combined with --merge-only or --shards");
+        }
+        if (show_progress && shards > 1) {
+            throw std::runtime_error("--progress cannot be combined with --shards");
+        }
+        if (records && (merge_only || shards > 1 || !base_text_path.empty())) {
+            throw std::runtime_error("--records cannot be combined with --merge-only, --base or "
+                                     "--shards");
+        }
+        if (strings && (records || binary || merge_only || shards > 1 || verify ||
+                        !base_text_path.empty())) {
+            throw std::runtime_error("--strings cannot be combined with --records, --binary, "
+                                     "--merge-only, --base, --shards or --verify");
+        }
         if (output_text_path.empty()) {
             throw std::runtime_error("Output file path is required (use -o or --output)");
         }
+        if (shards > 1 && parallel_io) {
+            throw std::runtime_error("--shards cannot be combined with --parallel-io");
+        }
+        if (simulate && shards > 1) {
+            throw std::runtime_error("--simulate cannot be combined with --shards");
+        }
+        if (retries > 0 && !simulate) {
+            throw std::runtime_error("--retries requires --simulate");
+        }
+        // A simulation charges the configured delays to its clock instead of sleeping them.
+        TapeDelays const tape_delays = simulate ? TapeDelays() : delays;
+
+        auto const stream_inputs =
+                std::count(input_text_paths.begin(), input_text_paths.end(), kStdStream);
+        bool const stream_input = stream_inputs > 0;
+        bool const stream_output = output_text_path == kStdStream;
+        if (stream_inputs > 1 || base_text_path == kStdStream) {
+            throw std::runtime_error("Standard input can be read only once, as an input");
+        }
+        if (stream_input && (shards > 1 || explain || strings)) {
+            throw std::runtime_error(
+                    "Standard input cannot be combined with --shards, --explain or --strings");
+        }
+        StreamFormat const format = binary ? StreamFormat::kBinary : StreamFormat::kText;
+
+        // Text input is converted to a temporary binary tape; binary input is used in place.
+        std::vector<std::string> input_bin_paths;
+        std::vector<std::string> converted_paths;
+        size_t string_records = 0;
+        auto const to_binary = [&](std::string const& path, SortVerifier* input_verifier) {
+            if (path == kStdStream) {
+                return std::string();
+            }
+            if (strings) {
+                converted_paths.push_back(path + ".records");
+                string_records += ConvertLinesToRecords(path, converted_paths.back());
+                return converted_paths.back();
+            }
+            if (binary) {
+                if (input_verifier != nullptr) {
+                    AddBinaryInput(path, *input_verifier);
+                }
+                return path;
+            }
+            converted_paths.push_back(path + ".bin");
+            ConvertTextToBinary(path, converted_paths.back(), input_verifier);
+            return converted_paths.back();
+        };
+        auto const remove_converted = [&converted_paths] {
+            for (auto const& path : converted_paths) {
+                std::filesystem::remove(path);
+            }
+        };
+
+        SortVerifier verifier(records ? 2 : 1);
+        SortVerifier* const input_verifier = verify ? &verifier : nullptr;
+
+        size_t elements = 0;
+        for (auto const& input_text_path : input_text_paths) {
+            input_bin_paths.push_back(to_binary(input_text_path, input_verifier));
+            if (!input_bin_paths.back().empty()) {
+                elements += std::filesystem::file_size(input_bin_paths.back()) / sizeof(int32_t);
+            }
+        }
 
-        std::string input_bin_path = input_text_path + ".bin";
-        std::string output_bin_path = output_text_path + ".bin";
+        std::string base_bin_path;
+        if (!base_text_path.empty()) {
+            base_bin_path = to_binary(base_text_path, input_verifier);
+        }
+
+        PlanRequest request;
+        request.elements = elements;
+        request.memory_bytes = memory_budget;
+        request.max_tapes = max_tapes;
+        request.block_size = block_size;
+        request.delays = delays;
+        SortPlan const plan =
+                stream_input ? SortPlanner::PlanUnknownSize(request) : SortPlanner::Plan(request);
+        size_t const sorted_elements =
+                base_bin_path.empty() ? 0
+                                      : std::filesystem::file_size(base_bin_path) / sizeof(int32_t);
+        size_t const sorted_records = strings ? string_records : records ? elements / 2 : elements;
+        SortProgress progress(stream_input ? 0 : sorted_records + sorted_elements);
+        MemoryBudget budget(memory_budget);
+        SortOptions options = plan.ToOptions(stream_input ? 0 : request.elements);
+        options.memory_budget = &budget;
+        options.progress = &progress;
+        options.sort_threads = sort_threads;
+
+        if (explain) {
+            SortPlanner::Explain(std::cout, request, plan);
+            remove_converted();
+            return 0;
+        }
 
-        ConvertTextToBinary(input_text_path, input_bin_path);
+        std::optional<OutputFile> output_file;
+        if (!stream_output) {
+            output_file.emplace(output_text_path, binary);
+        }
+        std::FILE* const output_stream = stream_output ? stdout : output_file->Get();
+        StreamOutputTape output_tape(output_stream, format, tape_delays, &budget, input_verifier,
+                                     records ? 2 : 1);
 
-        {
-            std::ofstream output_file(output_bin_path, std::ios::binary);
-            if (!output_file) {
-                throw std::runtime_error("Cannot create output binary file");
+        SimulationStats simulation;
+        TapeIoScheduler scheduler;
+        std::vector<std::unique_ptr<ITape>> input_tapes;
+        for (auto const& input_bin_path : input_bin_paths) {
+            if (input_bin_path.empty()) {
+                input_tapes.push_back(std::make_unique<StreamInputTape>(
+                        stdin, format, tape_delays, &budget, input_verifier));
+            } else {
+                input_tapes.push_back(
+                        std::make_unique<Tape>(input_bin_path, tape_delays, &budget));
             }
         }
+        std::unique_ptr<ITape> base_tape;
+        if (!base_bin_path.empty()) {
+            base_tape = std::make_unique<Tape>(base_bin_path, tape_delays, &budget);
+        }
 
-        Tape input_tape(input_bin_path, delays);
-        Tape output_tape(output_bin_path, delays);
+        if (temp_dirs.empty()) {
+            temp_dirs.push_back(std::filesystem::temp_directory_path().string());
+        }
+        std::string const& temp_dir = temp_dirs.front();
+        std::unique_ptr<ITapeFactory> factory =
+                std::make_unique<TmpTapeFactory>(temp_dirs, tape_delays, &budget, backend,
+                                                 placement);
 
-        std::string temp_dir = std::filesystem::temp_directory_path().string();
-        auto factory = std::make_unique<TmpTapeFactory>(temp_dir, delays);
+        std::optional<ProgressReporter> reporter;
+        if (show_progress) {
+            reporter.emplace(progress, std::chrono::seconds(1), PrintProgress);
+        }
 
-        TapeSorter sorter(block_size, std::move(factory));
-        sorter.Sort(input_tape, output_tape);
+        if (shards > 1) {
+#ifdef TAPE_SORTER_HAS_SHARDS
+            ShardedSorter sorter(shards, plan.block_size, temp_dir + "/tape-sorter-shards", delays,
+                                 options);
+            sorter.Sort(*input_tapes.front(), output_tape);
+#endif
+        } else {
+            ITape* output = &output_tape;
+            std::unique_ptr<ITape> simulated_output;
+            if (simulate) {
+                uint64_t stream = 0;
+                auto const simulated = [&](auto&& tape) {
+                    std::unique_ptr<ITape> result = std::make_unique<SimulatedTape>(
+                            std::forward<decltype(tape)>(tape), model, &simulation, stream++);
+                    if (retries > 0) {
+                        result = std::make_unique<RetryingTape>(std::move(result), retries + 1,
+                                                                &simulation);
+                    }
+                    return result;
+                };
+                for (auto& input_tape : input_tapes) {
+                    input_tape = simulated(std::move(input_tape));
+                }
+                if (base_tape) {
+                    base_tape = simulated(std::move(base_tape));
+                }
+                simulated_output = simulated(output_tape);
+                output = simulated_output.get();
+                factory = std::make_unique<SimulatedTapeFactory>(std::move(factory), model,
+                                                                 &simulation, retries + 1, stream);
+            }
+            std::unique_ptr<ScheduledTape> scheduled_output;
+            if (parallel_io) {
+                for (auto& input_tape : input_tapes) {
+                    input_tape = std::make_unique<ScheduledTape>(std::move(input_tape), scheduler);
+                }
+                if (base_tape) {
+                    base_tape = std::make_unique<ScheduledTape>(std::move(base_tape), scheduler);
+                }
+                scheduled_output = std::make_unique<ScheduledTape>(*output, scheduler);
+                output = scheduled_output.get();
+                factory = std::make_unique<ScheduledTapeFactory>(std::move(factory), scheduler);
+            }
+            if (verify) {
+                factory = std::make_unique<ChecksumTapeFactory>(std::move(factory), &budget);
+            }
 
-        ConvertBinaryToText(output_bin_path, output_text_path);
+            if (strings) {
+                // Sorted records are collected on a temp tape, then written out as lines.
+                auto sorted_tape = factory->Create();
+                StringSorter sorter(plan.block_size * sizeof(int32_t), std::move(factory),
+                                    options);
+                sorter.Sort(*input_tapes.front(), *sorted_tape);
+                WriteRecordLines(*sorted_tape, output_stream);
+            } else if (records) {
+                options.expected_elements /= 2;
+                RecordSorter sorter(std::max<size_t>(plan.block_size / 2, 1), std::move(factory),
+                                    options);
+                sorter.Sort(*input_tapes.front(), *output);
+            } else {
+                TapeSorter sorter(plan.block_size, std::move(factory), options);
+                if (merge_only) {
+                    std::vector<ITape*> inputs;
+                    for (auto const& input_tape : input_tapes) {
+                        inputs.push_back(input_tape.get());
+                    }
+                    sorter.MergeSorted(inputs, *output);
+                } else if (base_tape) {
+                    sorter.SortIncremental(*base_tape, *input_tapes.front(), *output);
+                } else {
+                    sorter.Sort(*input_tapes.front(), *output);
+                }
+            }
+            if (scheduled_output) {
+                scheduled_output->Flush();
+            }
+        }
+
+        reporter.reset();
+
+        output_tape.Flush();
+        if (output_file) {
+            output_file->Commit();
+        }
+        if (simulate) {
+            PrintSimulation(simulation);
+        }
+        if (verify) {
+            verifier.Check();
+            (stream_output ? std::cerr : std::cout)
+                    << "Verified: output is a sorted permutation of the input" << std::endl;
+        }
 
-        std::filesystem::remove(input_bin_path);
-        std::filesystem::remove(output_bin_path);
+        remove_converted();
         return 0;
     } catch (std::exception const& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -0,0 +1,82 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "async_tape_sorter.h"
+#include "memory_tape.h"
+
+class AsyncTapeSorterTest : public ::testing::Test {
+protected:
+    EventLoop loop_;
+
+    std::vector<int32_t> Sort(std::vector<int32_t> const& values, size_t block_size,
+                              TapeDelays const& delays = TapeDelays()) {
+        MemoryTape input(values);
+        MemoryTape output;
+        AsyncTapeAdapter async_input(input, loop_, delays);
+        AsyncTapeAdapter async_output(output, loop_, delays);
+
+        AsyncTapeSorter sorter(block_size, std::make_unique<AsyncTapeFactoryAdapter>(
+                                                   std::make_unique<MemoryTapeFactory>(),
+                                                   loop_, delays));
+        loop_.Run(sorter.Sort(async_input, async_output));
+        return output.GetData();
+    }
+};
+
+TEST_F(AsyncTapeSorterTest, SortHandlesEmptyInput) {
+    EXPECT_TRUE(Sort({}, 10).empty());
+}
+
+TEST_F(AsyncTapeSorterTest, SortWithMultipleBlocks) {
+    EXPECT_EQ(Sort({9, 7, 5, 3, 1, 8, 6, 4, 2}, 4),
+              (std::vector<int32_t>{1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST_F(AsyncTapeSorterTest, SortHandlesDuplicatesAndExtremes) {
+    EXPECT_EQ(Sort({3, INT32_MIN, 3, INT32_MAX, -1, 0}, 2),
+              (std::vector<int32_t>{INT32_MIN, -1, 0, 3, 3, INT32_MAX}));
+}
+
+TEST_F(AsyncTapeSorterTest, AdapterAppliesDelays) {
+    MemoryTape memory;
+    AsyncTapeAdapter tape(memory, loop_, TapeDelays(std::chrono::milliseconds(10)));
+
+    auto start = std::chrono::steady_clock::now();
+    int32_t value;
+    loop_.Run(tape.Read(value));
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(duration, std::chrono::milliseconds(10));
+}
+
+TEST_F(AsyncTapeSorterTest, SingleThreadDrivesTapesConcurrently) {
+    constexpr auto kDelay = std::chrono::milliseconds(20);
+    constexpr int kTapes = 10;
+
+    std::vector<MemoryTape> memory(kTapes);
+    std::vector<std::unique_ptr<AsyncTapeAdapter>> tapes;
+    std::vector<Task<void>> writes;
+    for (auto& tape : memory) {
+        tapes.push_back(
+                std::make_unique<AsyncTapeAdapter>(tape, loop_, TapeDelays({}, kDelay)));
+        writes.push_back(tapes.back()->Write(42));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    loop_.Run(WhenAll(std::move(writes)));
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    EXPECT_LT(duration, kDelay * kTapes / 2);
+    for (auto const& tape : memory) {
+        EXPECT_EQ(tape.GetData(), std::vector<int32_t>{42});
+    }
+}
+
+TEST_F(AsyncTapeSorterTest, PropagatesTapeErrors) {
+    MemoryTape memory;
+    AsyncTapeAdapter tape(memory, loop_, TapeDelays());
+
+    EXPECT_THROW(loop_.Run(tape.Move(MoveDirection::kBackward)), std::out_of_range);
+}
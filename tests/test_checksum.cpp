@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "checksum.h"
+#include "checksum_tape.h"
+#include "memory_tape.h"
+#include "tape_sorter.h"
+
+TEST(ChecksumTest, Crc32cMatchesKnownValue) {
+    std::string const data = "123456789";
+    EXPECT_EQ(Crc32cPortable(data.data(), data.size()), 0xE3069283);
+    EXPECT_EQ(Crc32c(data.data(), data.size()), 0xE3069283);
+}
+
+TEST(ChecksumTest, Crc32cChainsAcrossPieces) {
+    std::vector<unsigned char> data(1000);
+    std::iota(data.begin(), data.end(), 0);
+
+    uint32_t const whole = Crc32c(data.data(), data.size());
+    uint32_t const first = Crc32c(data.data(), 333);
+    EXPECT_EQ(Crc32c(data.data() + 333, data.size() - 333, first), whole);
+    EXPECT_EQ(Crc32cPortable(data.data(), data.size()), whole);
+}
+
+TEST(ChecksumTest, MultisetHashIgnoresOrder) {
+    MultisetHash forward;
+    MultisetHash backward;
+    for (uint64_t value = 0; value < 100; ++value) {
+        forward.Add(value);
+        backward.Add(99 - value);
+    }
+    EXPECT_EQ(forward, backward);
+
+    backward.Add(5);
+    EXPECT_FALSE(forward == backward);
+}
+
+TEST(ChecksumTest, VerifierAcceptsSortedPermutation) {
+    SortVerifier verifier;
+    for (int32_t value : {3, -1, 3, 7}) {
+        verifier.AddInput(value);
+    }
+    for (int32_t value : {-1, 3, 3, 7}) {
+        verifier.AddOutput(value);
+    }
+    EXPECT_NO_THROW(verifier.Check());
+}
+
+TEST(ChecksumTest, VerifierRejectsUnsortedOutput) {
+    SortVerifier verifier;
+    for (int32_t value : {1, 2, 3}) {
+        verifier.AddInput(value);
+    }
+    for (int32_t value : {1, 3, 2}) {
+        verifier.AddOutput(value);
+    }
+    EXPECT_THROW(verifier.Check(), std::runtime_error);
+}
+
+TEST(ChecksumTest, VerifierRejectsChangedOrMissingElements) {
+    SortVerifier changed;
+    SortVerifier missing;
+    for (int32_t value : {1, 2, 3}) {
+        changed.AddInput(value);
+        missing.AddInput(value);
+    }
+    for (int32_t value : {1, 2, 4}) {
+        changed.AddOutput(value);
+    }
+    for (int32_t value : {1, 2}) {
+        missing.AddOutput(value);
+    }
+    EXPECT_THROW(changed.Check(), std::runtime_error);
+    EXPECT_THROW(missing.Check(), std::runtime_error);
+}
+
+TEST(ChecksumTest, VerifierComparesRecordsByKey) {
+    SortVerifier verifier(2);
+    for (int32_t cell : {2, 10, 1, 20, 2, 30}) {
+        verifier.AddInput(cell);
+    }
+    for (int32_t cell : {1, 20, 2, 30, 2, 10}) {
+        verifier.AddOutput(cell);
+    }
+    EXPECT_NO_THROW(verifier.Check());
+
+    SortVerifier swapped_payloads(2);
+    for (int32_t cell : {1, 10, 2, 20}) {
+        swapped_payloads.AddInput(cell);
+    }
+    for (int32_t cell : {1, 20, 2, 10}) {
+        swapped_payloads.AddOutput(cell);
+    }
+    EXPECT_THROW(swapped_payloads.Check(), std::runtime_error);
+}
+
+TEST(ChecksumTapeTest, VerifiesBlocksInBothDirections) {
+    size_t const cells = 2 * ChecksumTape::kBlockCells + 10;
+    ChecksumTape tape(std::make_unique<MemoryTape>());
+    for (size_t idx = 0; idx < cells; ++idx) {
+        tape.Write(static_cast<int32_t>(idx));
+        tape.Move(MoveDirection::kForward);
+    }
+
+    int32_t value;
+    for (size_t idx = cells; idx > 0; --idx) {
+        tape.Move(MoveDirection::kBackward);
+        ASSERT_TRUE(tape.Read(value));
+        EXPECT_EQ(value, static_cast<int32_t>(idx - 1));
+    }
+
+    tape.Rewind();
+    for (size_t idx = 0; idx < cells; ++idx) {
+        ASSERT_TRUE(tape.Read(value));
+        tape.Move(MoveDirection::kForward);
+    }
+    EXPECT_FALSE(tape.Read(value));
+}
+
+TEST(ChecksumTapeTest, DetectsCorruptedCell) {
+    auto inner = std::make_unique<MemoryTape>();
+    MemoryTape* raw = inner.get();
+    ChecksumTape tape(std::move(inner));
+    for (int32_t value = 0; value < 10; ++value) {
+        tape.Write(value);
+        tape.Move(MoveDirection::kForward);
+    }
+
+    tape.Rewind();
+    raw->Move(MoveDirection::kForward);
+    raw->Write(42);
+    raw->Move(MoveDirection::kBackward);
+
+    int32_t value;
+    auto read_all = [&] {
+        while (tape.Read(value)) {
+            tape.Move(MoveDirection::kForward);
+        }
+    };
+    EXPECT_THROW(read_all(), std::runtime_error);
+}
+
+namespace {
+// Writes 0..count-1 to a checksummed tape, lets corrupt change the cells underneath it and reads
+// the tape back.
+template <typename Corrupt>
+void ReadCorrupted(int32_t const count, Corrupt const& corrupt) {
+    auto inner = std::make_unique<MemoryTape>();
+    MemoryTape* raw = inner.get();
+    ChecksumTape tape(std::move(inner));
+    for (int32_t value = 0; value < count; ++value) {
+        tape.Write(value);
+        tape.Move(MoveDirection::kForward);
+    }
+
+    std::vector<int32_t> cells = raw->GetData();
+    corrupt(cells);
+    tape.Rewind();
+    for (auto const cell : cells) {
+        raw->Write(cell);
+        raw->Move(MoveDirection::kForward);
+    }
+    raw->Rewind();
+
+    int32_t value;
+    while (tape.Read(value)) {
+        tape.Move(MoveDirection::kForward);
+    }
+}
+}  // namespace
+
+TEST(ChecksumTapeTest, DetectsSwappedCells) {
+    EXPECT_NO_THROW(ReadCorrupted(10, [](std::vector<int32_t>&) {}));
+    auto const swap = [](std::vector<int32_t>& cells) { std::swap(cells[2], cells[7]); };
+    EXPECT_THROW(ReadCorrupted(10, swap), std::runtime_error);
+}
+
+TEST(ChecksumTapeTest, DetectsSameBitFlippedInTwoCells) {
+    for (int bit = 0; bit < 32; ++bit) {
+        EXPECT_THROW(ReadCorrupted(10,
+                                   [bit](std::vector<int32_t>& cells) {
+                                       cells[3] ^= static_cast<int32_t>(1U << bit);
+                                       cells[8] ^= static_cast<int32_t>(1U << bit);
+                                   }),
+                     std::runtime_error)
+                << "bit " << bit;
+    }
+}
+
+TEST(ChecksumTapeTest, SorterRunsOnChecksummedTapes) {
+    std::vector<int32_t> input(5000);
+    std::iota(input.rbegin(), input.rend(), -2500);
+    MemoryTape input_tape(input);
+    MemoryTape output_tape;
+
+    TapeSorter sorter(300, std::make_unique<ChecksumTapeFactory>(
+                                   std::make_unique<MemoryTapeFactory>()),
+                      SortOptions{4, 0, MergeStrategy::kReadBackward});
+    sorter.Sort(input_tape, output_tape);
+
+    std::sort(input.begin(), input.end());
+    EXPECT_EQ(output_tape.GetData(), input);
+}
@@ -93,4 +93,39 @@ TEST_F(ConfigParserTest, IgnoresLinesWithoutDelimiter) {
 
     EXPECT_EQ(delays.read_delay_ms_.count(), 100);
     EXPECT_EQ(delays.write_delay_ms_.count(), 200);
-}
\ No newline at end of file
+}
+
+TEST_F(ConfigParserTest, ParsesDriveModel) {
+    std::string config =
+            "move_delay=2\n"
+            "start_delay_us=300\n"
+            "rewind_per_cell_ns=50\n"
+            "throughput_mb_s=160\n"
+            "jitter_percent=5\n"
+            "read_error_rate=0.001\n"
+            "write_error_rate=0.5\n"
+            "seed=42\n";
+
+    auto filename = createTempConfigFile(config);
+    auto model = ConfigParser::ParseModel(filename);
+
+    EXPECT_EQ(model.delays.move_delay_ms_.count(), 2);
+    EXPECT_EQ(model.start_delay.count(), 300);
+    EXPECT_EQ(model.rewind_per_cell.count(), 50);
+    EXPECT_EQ(model.throughput_mb_s, 160);
+    EXPECT_EQ(model.jitter_percent, 5);
+    EXPECT_DOUBLE_EQ(model.read_error_rate, 0.001);
+    EXPECT_DOUBLE_EQ(model.write_error_rate, 0.5);
+    EXPECT_EQ(model.seed, 42);
+
+    auto delays = ConfigParser::Parse(filename);
+    EXPECT_EQ(delays.move_delay_ms_.count(), 2);
+}
+
+TEST_F(ConfigParserTest, ThrowsOnInvalidDriveModelValue) {
+    for (std::string const config :
+         {"read_error_rate=1.5\n", "jitter_percent=101\n", "start_delay_us=-1\n", "seed=x\n"}) {
+        auto filename = createTempConfigFile(config);
+        EXPECT_THROW(ConfigParser::ParseModel(filename), std::runtime_error) << config;
+    }
+}
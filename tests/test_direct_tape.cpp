@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+#include "direct_tape.h"
+#include "memory_tape.h"
+#include "tape_sorter.h"
+
+class DirectTapeTest : public testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "direct_tape_test_dir";
+        std::filesystem::create_directories(test_dir_);
+        file_ = (test_dir_ / "tape").string();
+        std::ofstream(file_, std::ios::binary);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    std::vector<int32_t> ReadFile() const {
+        std::ifstream input(file_, std::ios::binary);
+        std::vector<int32_t> values;
+        int32_t value;
+        while (input.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+            values.push_back(value);
+        }
+        return values;
+    }
+
+    std::filesystem::path test_dir_;
+    std::string file_;
+};
+
+TEST_F(DirectTapeTest, ReadsBackAcrossBlocksInBothDirections) {
+    size_t const cells = 3 * DirectTape::kAlignment / sizeof(int32_t) + 7;
+    DirectTape tape(file_, TapeDelays{}, nullptr, DirectTape::kAlignment);
+    for (size_t idx = 0; idx < cells; ++idx) {
+        tape.Write(static_cast<int32_t>(idx));
+        tape.Move(MoveDirection::kForward);
+    }
+
+    int32_t value;
+    EXPECT_FALSE(tape.Read(value));
+    for (size_t idx = cells; idx > 0; --idx) {
+        tape.Move(MoveDirection::kBackward);
+        ASSERT_TRUE(tape.Read(value));
+        EXPECT_EQ(value, static_cast<int32_t>(idx - 1));
+    }
+    EXPECT_THROW(tape.Move(MoveDirection::kBackward), std::out_of_range);
+
+    tape.Rewind();
+    for (size_t idx = 0; idx < cells; ++idx) {
+        ASSERT_TRUE(tape.Read(value));
+        EXPECT_EQ(value, static_cast<int32_t>(idx));
+        tape.Move(MoveDirection::kForward);
+    }
+}
+
+TEST_F(DirectTapeTest, FlushLeavesExactFileContents) {
+    std::vector<int32_t> expected(2000);
+    std::iota(expected.begin(), expected.end(), -1000);
+    {
+        DirectTape tape(file_, TapeDelays{}, nullptr, DirectTape::kAlignment);
+        for (int32_t value : expected) {
+            tape.Write(value);
+            tape.Move(MoveDirection::kForward);
+        }
+        tape.Rewind();
+        tape.Write(42);
+        expected.front() = 42;
+    }
+
+    EXPECT_EQ(ReadFile(), expected);
+
+    DirectTape reopened(file_, TapeDelays{});
+    int32_t value;
+    ASSERT_TRUE(reopened.Read(value));
+    EXPECT_EQ(value, 42);
+}
+
+TEST_F(DirectTapeTest, ShrinksBlockToBudget) {
+    MemoryBudget budget(3 * DirectTape::kAlignment);
+    {
+        DirectTape tape(file_, TapeDelays{}, &budget);
+        EXPECT_LE(budget.Used(), budget.Limit());
+        EXPECT_GE(budget.Used(), DirectTape::kAlignment);
+    }
+    EXPECT_EQ(budget.Used(), 0);
+
+    MemoryBudget tiny(DirectTape::kAlignment - 1);
+    EXPECT_THROW(DirectTape(file_, TapeDelays{}, &tiny), MemoryBudgetExceeded);
+}
+
+TEST_F(DirectTapeTest, SorterRunsOnDirectTempTapes) {
+    std::vector<int32_t> input(20000);
+    std::iota(input.rbegin(), input.rend(), 0);
+    MemoryTape input_tape(input);
+    MemoryTape output_tape;
+
+    TapeSorter sorter(1000, std::make_unique<TmpTapeFactory>((test_dir_ / "tmp").string(),
+                                                             TapeDelays{}, nullptr,
+                                                             TapeBackend::kDirect),
+                      SortOptions{4, 0, MergeStrategy::kReadBackward});
+    sorter.Sort(input_tape, output_tape);
+
+    std::sort(input.begin(), input.end());
+    EXPECT_EQ(output_tape.GetData(), input);
+}
+
+TEST_F(DirectTapeTest, FactoryFallsBackToStreamTapesWhenBudgetRunsOut) {
+    std::vector<int32_t> input(20000);
+    std::iota(input.rbegin(), input.rend(), 0);
+    auto expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    // Small blocks make many run tapes. Every direct tape takes a share of what is left, so later
+    // ones find too little budget for an aligned block.
+    for (size_t limit : {16 * 1024, 32 * 1024, 128 * 1024}) {
+        MemoryBudget budget(limit);
+        SortOptions options{3, input.size(), MergeStrategy::kReadBackward};
+        options.memory_budget = &budget;
+        MemoryTape input_tape(input);
+        MemoryTape output_tape;
+
+        TapeSorter sorter(TapeSorter::MaxBlockSize(limit) / 8,
+                          std::make_unique<TmpTapeFactory>((test_dir_ / "tmp").string(),
+                                                           TapeDelays{}, &budget,
+                                                           TapeBackend::kDirect),
+                          options);
+        sorter.Sort(input_tape, output_tape);
+
+        EXPECT_EQ(output_tape.GetData(), expected) << limit << " bytes";
+        EXPECT_LE(budget.Peak(), budget.Limit());
+    }
+}
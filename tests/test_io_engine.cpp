@@ -0,0 +1,200 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+#include "io_engine.h"
+#include "io_engine_tape.h"
+#include "memory_tape.h"
+#include "tape_sorter.h"
+
+class IoEngineTest : public testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "io_engine_test_dir";
+        std::filesystem::create_directories(test_dir_);
+        file_ = (test_dir_ / "tape").string();
+        std::ofstream(file_, std::ios::binary);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    static void CheckReadWrite(IoEngine& engine, std::string const& file) {
+        int fd = open(file.c_str(), O_RDWR);
+        ASSERT_GE(fd, 0);
+
+        std::vector<std::vector<int32_t>> chunks(8, std::vector<int32_t>(1000));
+        std::vector<std::future<size_t>> writes;
+        for (size_t idx = 0; idx < chunks.size(); ++idx) {
+            std::iota(chunks[idx].begin(), chunks[idx].end(), static_cast<int32_t>(idx * 1000));
+            writes.push_back(engine.Write(fd, chunks[idx].data(), 4000, idx * 4000));
+        }
+        engine.Submit();
+        for (auto& write : writes) {
+            EXPECT_EQ(write.get(), 4000);
+        }
+
+        std::vector<int32_t> back(8000);
+        std::vector<std::future<size_t>> reads;
+        for (size_t idx = 0; idx < chunks.size(); ++idx) {
+            reads.push_back(engine.Read(fd, back.data() + idx * 1000, 4000, idx * 4000));
+        }
+        auto past_end = engine.Read(fd, back.data(), 4000, 32000);
+        engine.Submit();
+        for (auto& read : reads) {
+            EXPECT_EQ(read.get(), 4000);
+        }
+        EXPECT_EQ(past_end.get(), 0);
+
+        std::vector<int32_t> expected(8000);
+        std::iota(expected.begin(), expected.end(), 0);
+        EXPECT_EQ(back, expected);
+
+        auto bad = engine.Read(-1, back.data(), 4000, 0);
+        engine.Submit();
+        EXPECT_THROW(bad.get(), std::system_error);
+        close(fd);
+    }
+
+    std::filesystem::path test_dir_;
+    std::string file_;
+};
+
+TEST_F(IoEngineTest, ThreadPoolReadsAndWrites) {
+    ThreadPoolIoEngine engine(2);
+    CheckReadWrite(engine, file_);
+}
+
+#ifdef TAPE_SORTER_HAS_IO_URING
+TEST_F(IoEngineTest, UringReadsAndWrites) {
+    std::unique_ptr<UringIoEngine> engine;
+    try {
+        engine = std::make_unique<UringIoEngine>(4);
+    } catch (std::system_error const&) {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+    CheckReadWrite(*engine, file_);
+}
+#endif
+
+TEST_F(IoEngineTest, TapeReadsBackAcrossBlocksInBothDirections) {
+    size_t const cells = 5 * IoEngineTape::kAlignment / sizeof(int32_t) + 7;
+    {
+        IoEngineTape tape(file_, TapeDelays{}, IoEngine::Create(), nullptr,
+                          IoEngineTape::kAlignment);
+        for (size_t idx = 0; idx < cells; ++idx) {
+            tape.Write(static_cast<int32_t>(idx));
+            tape.Move(MoveDirection::kForward);
+        }
+
+        int32_t value;
+        EXPECT_FALSE(tape.Read(value));
+        for (size_t idx = cells; idx > 0; --idx) {
+            tape.Move(MoveDirection::kBackward);
+            ASSERT_TRUE(tape.Read(value));
+            EXPECT_EQ(value, static_cast<int32_t>(idx - 1));
+        }
+        EXPECT_THROW(tape.Move(MoveDirection::kBackward), std::out_of_range);
+
+        tape.Write(-1);
+        for (size_t idx = 0; idx < cells; ++idx) {
+            ASSERT_TRUE(tape.Read(value));
+            EXPECT_EQ(value, idx == 0 ? -1 : static_cast<int32_t>(idx));
+            tape.Move(MoveDirection::kForward);
+        }
+    }
+
+    std::ifstream input(file_, std::ios::binary);
+    std::vector<int32_t> values(cells + 1);
+    input.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(int32_t));
+    EXPECT_EQ(input.gcount(), cells * sizeof(int32_t));
+    EXPECT_EQ(values[0], -1);
+    EXPECT_EQ(values[cells - 1], static_cast<int32_t>(cells - 1));
+}
+
+TEST_F(IoEngineTest, TapeShrinksBlocksToBudget) {
+    MemoryBudget budget(8 * IoEngineTape::kAlignment);
+    {
+        IoEngineTape tape(file_, TapeDelays{}, IoEngine::Create(), &budget);
+        EXPECT_LE(budget.Used(), budget.Limit());
+        EXPECT_GE(budget.Used(), IoEngineTape::kSlots * IoEngineTape::kAlignment);
+    }
+    EXPECT_EQ(budget.Used(), 0);
+
+    MemoryBudget tiny(IoEngineTape::kSlots * IoEngineTape::kAlignment - 1);
+    EXPECT_THROW(IoEngineTape(file_, TapeDelays{}, IoEngine::Create(), &tiny),
+                 MemoryBudgetExceeded);
+}
+
+TEST_F(IoEngineTest, SorterRunsOnIoEngineTempTapes) {
+    std::vector<int32_t> input(50000);
+    std::iota(input.rbegin(), input.rend(), 0);
+    MemoryTape input_tape(input);
+    MemoryTape output_tape;
+
+    TapeSorter sorter(1000, std::make_unique<TmpTapeFactory>((test_dir_ / "tmp").string(),
+                                                             TapeDelays{}, nullptr,
+                                                             TapeBackend::kIoEngine),
+                      SortOptions{4, 0, MergeStrategy::kReadBackward});
+    sorter.Sort(input_tape, output_tape);
+
+    std::sort(input.begin(), input.end());
+    EXPECT_EQ(output_tape.GetData(), input);
+}
+
+TEST_F(IoEngineTest, FactoryCreatesManyTapesUnderSmallBudget) {
+    MemoryBudget budget(32 * 1024);
+    {
+        TmpTapeFactory factory((test_dir_ / "tmp").string(), TapeDelays{}, &budget,
+                               TapeBackend::kIoEngine);
+        // Once the block slots no longer fit, the factory falls back to stream tapes.
+        std::vector<std::unique_ptr<ITape>> tapes;
+        for (int32_t idx = 0; idx < 64; ++idx) {
+            tapes.push_back(factory.Create());
+            tapes.back()->Write(idx);
+            tapes.back()->Move(MoveDirection::kForward);
+        }
+        EXPECT_LE(budget.Peak(), budget.Limit());
+
+        for (int32_t idx = 0; idx < 64; ++idx) {
+            auto& tape = *tapes[static_cast<size_t>(idx)];
+            tape.Move(MoveDirection::kBackward);
+            int32_t value = -1;
+            ASSERT_TRUE(tape.Read(value));
+            EXPECT_EQ(value, idx);
+        }
+    }
+    EXPECT_EQ(budget.Used(), 0);
+}
+
+TEST_F(IoEngineTest, SorterRunsOnIoEngineTempTapesUnderSmallBudget) {
+    std::vector<int32_t> input(20000);
+    std::iota(input.rbegin(), input.rend(), 0);
+    auto expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    for (size_t limit : {32 * 1024, 128 * 1024, 256 * 1024}) {
+        MemoryBudget budget(limit);
+        SortOptions options{3, input.size(), MergeStrategy::kReadBackward};
+        options.memory_budget = &budget;
+        MemoryTape input_tape(input);
+        MemoryTape output_tape;
+
+        TapeSorter sorter(TapeSorter::MaxBlockSize(limit) / 8,
+                          std::make_unique<TmpTapeFactory>((test_dir_ / "tmp").string(),
+                                                           TapeDelays{}, &budget,
+                                                           TapeBackend::kIoEngine),
+                          options);
+        sorter.Sort(input_tape, output_tape);
+
+        EXPECT_EQ(output_tape.GetData(), expected) << limit << " bytes";
+        EXPECT_LE(budget.Peak(), budget.Limit());
+    }
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "memory_budget.h"
+#include "memory_tape.h"
+#include "tape_sorter.h"
+#include "tmp_tape_factory.h"
+
+TEST(MemoryBudgetTest, TracksReservations) {
+    MemoryBudget budget(100);
+
+    budget.Reserve(60);
+    EXPECT_EQ(budget.Used(), 60);
+    EXPECT_EQ(budget.Available(), 40);
+    EXPECT_FALSE(budget.TryReserve(41));
+    EXPECT_THROW(budget.Reserve(41), MemoryBudgetExceeded);
+
+    budget.Release(60);
+    EXPECT_EQ(budget.Used(), 0);
+    EXPECT_EQ(budget.Peak(), 60);
+}
+
+TEST(MemoryBudgetTest, AllocatorDrawsFromBudget) {
+    MemoryBudget budget(1024);
+    {
+        BudgetVector<int32_t> values{BudgetAllocator<int32_t>(&budget)};
+        values.reserve(100);
+        EXPECT_EQ(budget.Used(), 100 * sizeof(int32_t));
+        EXPECT_THROW(values.reserve(1000), MemoryBudgetExceeded);
+    }
+    EXPECT_EQ(budget.Used(), 0);
+}
+
+TEST(MemoryBudgetTest, SorterStaysWithinBudget) {
+    std::vector<int32_t> input(1000);
+    std::iota(input.begin(), input.end(), -500);
+    std::shuffle(input.begin(), input.end(), std::mt19937(42));
+    std::vector<int32_t> expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    MemoryBudget budget(1024);
+    MemoryTape input_tape(input);
+    MemoryTape output_tape;
+
+    SortOptions options;
+    options.memory_budget = &budget;
+    TapeSorter sorter(input.size(), std::make_unique<MemoryTapeFactory>(), options);
+    sorter.Sort(input_tape, output_tape);
+
+    EXPECT_EQ(output_tape.GetData(), expected);
+    EXPECT_LE(budget.Peak(), budget.Limit());
+    EXPECT_EQ(budget.Used(), 0);
+}
+
+TEST(MemoryBudgetTest, SorterLimitsFanInToBudget) {
+    std::vector<int32_t> input(64);
+    std::iota(input.rbegin(), input.rend(), 0);
+
+    MemoryBudget budget(4 * TapeSorter::kMergeBytesPerRun);
+    MemoryTape input_tape(input);
+    MemoryTape output_tape;
+
+    SortOptions options;
+    options.memory_budget = &budget;
+    TapeSorter sorter(1, std::make_unique<MemoryTapeFactory>(), options);
+    sorter.Sort(input_tape, output_tape);
+
+    std::sort(input.begin(), input.end());
+    EXPECT_EQ(output_tape.GetData(), input);
+    EXPECT_LE(budget.Peak(), budget.Limit());
+}
+
+TEST(MemoryBudgetTest, SorterThrowsWhenBudgetIsTooSmall) {
+    MemoryBudget budget(2);
+    MemoryTape input_tape({3, 1, 2});
+    MemoryTape output_tape;
+
+    SortOptions options;
+    options.memory_budget = &budget;
+    TapeSorter sorter(10, std::make_unique<MemoryTapeFactory>(), options);
+
+    EXPECT_THROW(sorter.Sort(input_tape, output_tape), MemoryBudgetExceeded);
+}
+
+TEST(MemoryBudgetTest, SorterLeavesRoomForMergeAfterTapeBuffers) {
+    std::vector<int32_t> input(20000);
+    std::iota(input.begin(), input.end(), 0);
+    std::shuffle(input.begin(), input.end(), std::mt19937(7));
+    std::vector<int32_t> expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    auto const dir = std::filesystem::temp_directory_path() / "budget_test_dir";
+    for (size_t limit : {16 * 1024, 32 * 1024, 64 * 1024}) {
+        for (size_t fan_in : {2, 3, 4, 8}) {
+            // Temp tapes take their buffers from the budget until it runs out.
+            MemoryBudget budget(limit);
+            MemoryTape input_tape(input);
+            MemoryTape output_tape;
+
+            SortOptions options{fan_in, input.size(), MergeStrategy::kReadBackward};
+            options.memory_budget = &budget;
+            TapeSorter sorter(TapeSorter::MaxBlockSize(limit),
+                              std::make_unique<TmpTapeFactory>(dir.string(), TapeDelays(), &budget),
+                              options);
+            sorter.Sort(input_tape, output_tape);
+
+            EXPECT_EQ(output_tape.GetData(), expected) << limit << " bytes, fan-in " << fan_in;
+            EXPECT_LE(budget.Peak(), budget.Limit());
+        }
+    }
+    std::filesystem::remove_all(dir);
+}
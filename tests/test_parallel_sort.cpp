@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <functional>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "memory_tape.h"
+#include "parallel_sort.h"
+#include "tape_sorter.h"
+
+TEST(ParallelSortTest, MatchesStdSort) {
+    std::mt19937 random(7);
+    for (size_t threads : {2, 3, 8}) {
+        std::vector<int32_t> values(100'000);
+        for (auto& value : values) {
+            value = static_cast<int32_t>(random());
+        }
+        auto expected = values;
+        std::sort(expected.begin(), expected.end());
+
+        ParallelSort(values.begin(), values.end(), std::less<>(), threads, 1000);
+        EXPECT_EQ(values, expected);
+    }
+}
+
+TEST(ParallelSortTest, HandlesDuplicatesAndDescendingOrder) {
+    std::vector<int32_t> values(50'000);
+    for (size_t idx = 0; idx < values.size(); ++idx) {
+        values[idx] = static_cast<int32_t>(idx % 3);
+    }
+    auto expected = values;
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+
+    ParallelSort(values.begin(), values.end(), std::greater<>(), 4, 100);
+    EXPECT_EQ(values, expected);
+
+    std::vector<int32_t> same(10'000, 5);
+    ParallelSort(same.begin(), same.end(), std::less<>(), 4, 100);
+    EXPECT_EQ(same, std::vector<int32_t>(10'000, 5));
+}
+
+TEST(ParallelSortTest, SorterUsesThreadsForLargeBlocks) {
+    std::vector<int32_t> input(3 * kParallelSortMinElements);
+    std::iota(input.rbegin(), input.rend(), -100);
+    MemoryTape input_tape(input);
+    MemoryTape output_tape;
+
+    SortOptions options;
+    options.sort_threads = 4;
+    TapeSorter sorter(2 * kParallelSortMinElements, std::make_unique<MemoryTapeFactory>(),
+                      options);
+    sorter.Sort(input_tape, output_tape);
+
+    std::sort(input.begin(), input.end());
+    EXPECT_EQ(output_tape.GetData(), input);
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "memory_tape.h"
+#include "record_sorter.h"
+
+namespace {
+std::vector<int32_t> Flatten(std::vector<Record> const& records) {
+    std::vector<int32_t> cells;
+    for (auto const& record : records) {
+        cells.push_back(record.key);
+        cells.push_back(record.payload);
+    }
+    return cells;
+}
+
+std::vector<Record> ArrivalOrderedRecords(size_t count, int32_t keys) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int32_t> key(0, keys - 1);
+    std::vector<Record> records;
+    for (size_t idx = 0; idx < count; ++idx) {
+        records.push_back({key(random), static_cast<int32_t>(idx)});
+    }
+    return records;
+}
+
+std::vector<Record> StableSorted(std::vector<Record> records) {
+    std::stable_sort(records.begin(), records.end(),
+                     [](Record const& lhs, Record const& rhs) { return lhs.key < rhs.key; });
+    return records;
+}
+}  // namespace
+
+TEST(RecordSorterTest, SortHandlesEmptyInput) {
+    MemoryTape input_tape;
+    MemoryTape output_tape;
+
+    RecordSorter sorter(4, std::make_unique<MemoryTapeFactory>());
+    sorter.Sort(input_tape, output_tape);
+
+    EXPECT_TRUE(output_tape.GetData().empty());
+}
+
+TEST(RecordSorterTest, SortKeepsArrivalOrderForEqualKeys) {
+    auto const records = ArrivalOrderedRecords(200, 5);
+    auto const expected = Flatten(StableSorted(records));
+
+    for (size_t block : {1, 3, 16, 500}) {
+        for (size_t fan_in : {0, 2, 3}) {
+            for (auto strategy : {MergeStrategy::kReadBackward, MergeStrategy::kRewind}) {
+                MemoryTape input_tape(Flatten(records));
+                MemoryTape output_tape;
+
+                RecordSorter sorter(block, std::make_unique<MemoryTapeFactory>(),
+                                    SortOptions{fan_in, 0, strategy});
+                sorter.Sort(input_tape, output_tape);
+
+                EXPECT_EQ(output_tape.GetData(), expected)
+                        << "block " << block << ", fan-in " << fan_in;
+            }
+        }
+    }
+}
+
+TEST(RecordSorterTest, SortIsStableWithExpectedSize) {
+    auto const records = ArrivalOrderedRecords(64, 3);
+    MemoryTape input_tape(Flatten(records));
+    MemoryTape output_tape;
+
+    RecordSorter sorter(4, std::make_unique<MemoryTapeFactory>(),
+                        SortOptions{2, records.size(), MergeStrategy::kReadBackward});
+    sorter.Sort(input_tape, output_tape);
+
+    EXPECT_EQ(output_tape.GetData(), Flatten(StableSorted(records)));
+}
+
+TEST(RecordSorterTest, SortRejectsTruncatedRecord) {
+    MemoryTape input_tape({3, 1, 2});
+    MemoryTape output_tape;
+
+    RecordSorter sorter(4, std::make_unique<MemoryTapeFactory>());
+    EXPECT_THROW(sorter.Sort(input_tape, output_tape), std::runtime_error);
+}
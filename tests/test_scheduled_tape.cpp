@@ -0,0 +1,152 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "memory_tape.h"
+#include "scheduled_tape.h"
+#include "tape_sorter.h"
+
+class SlowWriteTape : public MemoryTape {
+public:
+    explicit SlowWriteTape(std::chrono::milliseconds delay) : delay_(delay) {}
+
+    void Write(int32_t value) override {
+        std::this_thread::sleep_for(delay_);
+        MemoryTape::Write(value);
+    }
+
+private:
+    std::chrono::milliseconds delay_;
+};
+
+TEST(TapeIoSchedulerTest, AssignsDedicatedDrives) {
+    TapeIoScheduler scheduler;
+    auto& first = scheduler.Acquire();
+    auto& second = scheduler.Acquire();
+
+    EXPECT_NE(&first, &second);
+    EXPECT_EQ(scheduler.DriveCount(), 2);
+
+    scheduler.Release(first);
+    auto& third = scheduler.Acquire();
+    EXPECT_EQ(&first, &third);
+    EXPECT_EQ(scheduler.DriveCount(), 2);
+}
+
+TEST(TapeIoSchedulerTest, SharesDrivesOverLimit) {
+    TapeIoScheduler scheduler(1);
+    auto& first = scheduler.Acquire();
+    auto& second = scheduler.Acquire();
+
+    EXPECT_EQ(&first, &second);
+    EXPECT_EQ(scheduler.DriveCount(), 1);
+}
+
+TEST(ScheduledTapeTest, ReadsAndWritesLikeUnderlyingTape) {
+    TapeIoScheduler scheduler;
+    MemoryTape memory;
+    {
+        ScheduledTape tape(memory, scheduler);
+        for (int32_t value : {10, 20, 30, 40}) {
+            tape.Write(value);
+            tape.Move(MoveDirection::kForward);
+        }
+        tape.Rewind();
+
+        int32_t value;
+        ASSERT_TRUE(tape.Read(value));
+        EXPECT_EQ(value, 10);
+        tape.Move(MoveDirection::kForward);
+        ASSERT_TRUE(tape.Read(value));
+        EXPECT_EQ(value, 20);
+
+        tape.Write(25);
+        tape.Move(MoveDirection::kForward);
+        ASSERT_TRUE(tape.Read(value));
+        EXPECT_EQ(value, 30);
+
+        tape.Move(MoveDirection::kBackward);
+        ASSERT_TRUE(tape.Read(value));
+        EXPECT_EQ(value, 25);
+        tape.Flush();
+    }
+
+    EXPECT_EQ(memory.GetData(), (std::vector<int32_t>{10, 25, 30, 40}));
+}
+
+TEST(ScheduledTapeTest, ReadsBackwardWithPrefetch) {
+    TapeIoScheduler scheduler;
+    MemoryTape memory({1, 2, 3, 4, 5});
+    ScheduledTape tape(memory, scheduler);
+
+    for (int i = 0; i < 4; ++i) {
+        tape.Move(MoveDirection::kForward);
+    }
+
+    std::vector<int32_t> values;
+    int32_t value;
+    ASSERT_TRUE(tape.Read(value));
+    values.push_back(value);
+    for (int i = 0; i < 4; ++i) {
+        tape.Move(MoveDirection::kBackward);
+        ASSERT_TRUE(tape.Read(value));
+        values.push_back(value);
+    }
+
+    EXPECT_EQ(values, (std::vector<int32_t>{5, 4, 3, 2, 1}));
+    EXPECT_THROW(tape.Move(MoveDirection::kBackward), std::out_of_range);
+}
+
+TEST(ScheduledTapeTest, RethrowsDeferredErrors) {
+    TapeIoScheduler scheduler;
+    MemoryTape memory;
+    ScheduledTape tape(memory, scheduler);
+
+    tape.Move(MoveDirection::kBackward);
+    EXPECT_THROW(tape.Flush(), std::out_of_range);
+}
+
+TEST(ScheduledTapeTest, OverlapsOperationsAcrossDrives) {
+    constexpr auto kDelay = std::chrono::milliseconds(10);
+    constexpr int kTapes = 4;
+    constexpr int kValues = 5;
+
+    TapeIoScheduler scheduler;
+    std::vector<std::unique_ptr<ScheduledTape>> tapes;
+    for (int i = 0; i < kTapes; ++i) {
+        tapes.push_back(std::make_unique<ScheduledTape>(std::make_unique<SlowWriteTape>(kDelay),
+                                                        scheduler));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int value = 0; value < kValues; ++value) {
+        for (auto& tape : tapes) {
+            tape->Write(value);
+            tape->Move(MoveDirection::kForward);
+        }
+    }
+    for (auto& tape : tapes) {
+        tape->Flush();
+    }
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    EXPECT_LT(duration, kDelay * kTapes * kValues * 3 / 4);
+}
+
+TEST(ScheduledTapeTest, SorterProducesSortedOutput) {
+    TapeIoScheduler scheduler;
+    MemoryTape input({9, 7, 5, 3, 1, 8, 6, 4, 2, 0});
+    MemoryTape output;
+    {
+        ScheduledTape scheduled_input(input, scheduler);
+        ScheduledTape scheduled_output(output, scheduler);
+        TapeSorter sorter(3, std::make_unique<ScheduledTapeFactory>(
+                                     std::make_unique<MemoryTapeFactory>(), scheduler));
+        sorter.Sort(scheduled_input, scheduled_output);
+        scheduled_output.Flush();
+    }
+
+    EXPECT_EQ(output.GetData(), (std::vector<int32_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "memory_tape.h"
+#include "sharded_sorter.h"
+
+class ShardedSorterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        work_dir_ = std::filesystem::temp_directory_path() / "tape_shard_test_dir";
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(work_dir_);
+    }
+
+    std::vector<int32_t> Sort(std::vector<int32_t> const& values, size_t shards) {
+        MemoryTape input(values);
+        MemoryTape output;
+        ShardedSorter sorter(shards, 16, work_dir_.string(), TapeDelays());
+        sorter.Sort(input, output);
+        return output.GetData();
+    }
+
+    std::filesystem::path work_dir_;
+};
+
+TEST_F(ShardedSorterTest, ChoosesSplittersFromSampleQuantiles) {
+    std::vector<int32_t> samples(100);
+    std::iota(samples.rbegin(), samples.rend(), 0);
+
+    EXPECT_EQ(ShardedSorter::ChooseSplitters(samples, 4), (std::vector<int32_t>{25, 50, 75}));
+    EXPECT_TRUE(ShardedSorter::ChooseSplitters({}, 4).empty());
+}
+
+TEST_F(ShardedSorterTest, SortsAcrossWorkers) {
+    std::vector<int32_t> values(5000);
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int32_t> distribution(INT32_MIN, INT32_MAX);
+    std::generate(values.begin(), values.end(), [&] { return distribution(random); });
+
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    EXPECT_EQ(Sort(values, 4), expected);
+}
+
+TEST_F(ShardedSorterTest, HandlesSkewedInput) {
+    std::vector<int32_t> values(1000, 7);
+    values.push_back(-1);
+
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    EXPECT_EQ(Sort(values, 3), expected);
+}
+
+TEST_F(ShardedSorterTest, HandlesEmptyInput) {
+    EXPECT_TRUE(Sort({}, 2).empty());
+}
+
+TEST_F(ShardedSorterTest, SplitsMemoryBudgetAcrossWorkers) {
+    std::vector<int32_t> values(1000);
+    std::iota(values.rbegin(), values.rend(), 0);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    // Enough for one worker, but a quarter of it cannot hold two merge readers.
+    MemoryBudget budget(4 * TapeSorter::kMergeBytesPerRun);
+    SortOptions options;
+    options.memory_budget = &budget;
+    for (size_t shards : {1, 4}) {
+        MemoryTape input(values);
+        MemoryTape output;
+        ShardedSorter sorter(shards, 16, work_dir_.string(), TapeDelays(), options);
+        if (shards == 1) {
+            sorter.Sort(input, output);
+            EXPECT_EQ(output.GetData(), expected);
+        } else {
+            EXPECT_THROW(sorter.Sort(input, output), std::runtime_error);
+        }
+    }
+}
+
+TEST_F(ShardedSorterTest, RemovesShardDirectories) {
+    Sort({3, 2, 1}, 2);
+
+    EXPECT_TRUE(std::filesystem::is_empty(work_dir_));
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "memory_tape.h"
+#include "simulated_tape.h"
+#include "tape_sorter.h"
+
+namespace {
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+
+TapeModel FaultyModel(double const error_rate, uint64_t const seed) {
+    TapeModel model;
+    model.read_error_rate = error_rate;
+    model.write_error_rate = error_rate;
+    model.seed = seed;
+    return model;
+}
+
+// Writes values, then reads them back, counting the injected failures. A failed operation is
+// repeated until it succeeds.
+std::vector<size_t> FailurePositions(TapeModel const& model, uint64_t const stream) {
+    MemoryTape memory;
+    SimulatedTape tape(memory, model, nullptr, stream);
+    std::vector<size_t> failures;
+    for (int32_t value = 0; value < 200; ++value) {
+        while (true) {
+            try {
+                tape.Write(value);
+                break;
+            } catch (TapeFault const&) {
+                failures.push_back(static_cast<size_t>(value));
+            }
+        }
+        tape.Move(MoveDirection::kForward);
+    }
+    return failures;
+}
+}  // namespace
+
+TEST(SimulatedTapeTest, ChargesStreamingMovesLessThanTurnarounds) {
+    TapeModel model;
+    model.delays.move_delay_ms_ = milliseconds(1);
+    model.start_delay = microseconds(500);
+
+    MemoryTape memory;
+    SimulationStats stats;
+    SimulatedTape tape(memory, model, &stats);
+    for (int i = 0; i < 4; ++i) {
+        tape.Write(i);
+        tape.Move(MoveDirection::kForward);
+    }
+    EXPECT_EQ(tape.Elapsed(), milliseconds(4) + microseconds(500));
+
+    tape.Move(MoveDirection::kBackward);
+    tape.Move(MoveDirection::kBackward);
+    EXPECT_EQ(tape.Elapsed(), milliseconds(6) + microseconds(1000));
+    EXPECT_EQ(stats.moves, 6);
+    EXPECT_EQ(stats.turnarounds, 1);
+    EXPECT_EQ(stats.Elapsed(), tape.Elapsed());
+}
+
+TEST(SimulatedTapeTest, ChargesRewindByPosition) {
+    TapeModel model;
+    model.delays.rewind_delay_ms_ = milliseconds(2);
+    model.rewind_per_cell = nanoseconds(100);
+
+    MemoryTape memory;
+    SimulatedTape tape(memory, model);
+    for (int i = 0; i < 10; ++i) {
+        tape.Write(i);
+        tape.Move(MoveDirection::kForward);
+    }
+    tape.Rewind();
+    EXPECT_EQ(tape.Elapsed(), milliseconds(2) + nanoseconds(1000));
+    tape.Rewind();
+    EXPECT_EQ(tape.Elapsed(), milliseconds(4) + nanoseconds(1000));
+}
+
+TEST(SimulatedTapeTest, LimitsThroughput) {
+    TapeModel model;
+    model.throughput_mb_s = 4;
+
+    MemoryTape memory;
+    SimulatedTape tape(memory, model);
+    tape.Write(1);
+    int32_t value = 0;
+    EXPECT_TRUE(tape.Read(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_EQ(tape.Elapsed(), microseconds(2));
+}
+
+TEST(SimulatedTapeTest, JitterStaysWithinBoundsAndRepeats) {
+    TapeModel model;
+    model.delays.move_delay_ms_ = milliseconds(10);
+    model.jitter_percent = 20;
+    model.seed = 7;
+
+    auto const run = [&model] {
+        MemoryTape memory;
+        SimulatedTape tape(memory, model);
+        for (int i = 0; i < 100; ++i) {
+            tape.Move(MoveDirection::kForward);
+        }
+        return tape.Elapsed();
+    };
+    auto const elapsed = run();
+    EXPECT_GE(elapsed, milliseconds(800));
+    EXPECT_LE(elapsed, milliseconds(1200));
+    EXPECT_NE(elapsed, milliseconds(1000));
+    EXPECT_EQ(run(), elapsed);
+}
+
+TEST(SimulatedTapeTest, FailuresDependOnSeedAndStream) {
+    auto const failures = FailurePositions(FaultyModel(0.1, 1), 0);
+    EXPECT_FALSE(failures.empty());
+    EXPECT_EQ(FailurePositions(FaultyModel(0.1, 1), 0), failures);
+    EXPECT_NE(FailurePositions(FaultyModel(0.1, 1), 1), failures);
+    EXPECT_NE(FailurePositions(FaultyModel(0.1, 2), 0), failures);
+    EXPECT_TRUE(FailurePositions(FaultyModel(0, 1), 0).empty());
+}
+
+TEST(SimulatedTapeTest, FailedWriteLeavesTapeUnchanged) {
+    MemoryTape memory;
+    SimulatedTape tape(memory, FaultyModel(1, 0));
+    EXPECT_THROW(tape.Write(5), TapeFault);
+    int32_t value = 0;
+    EXPECT_FALSE(memory.Read(value));
+}
+
+TEST(RetryingTapeTest, RetriesInjectedFailures) {
+    SimulationStats stats;
+    auto simulated =
+            std::make_unique<SimulatedTape>(std::make_unique<MemoryTape>(), FaultyModel(0.3, 3),
+                                            &stats);
+    RetryingTape tape(std::move(simulated), 100, &stats);
+    for (int32_t value = 0; value < 100; ++value) {
+        tape.Write(value);
+        tape.Move(MoveDirection::kForward);
+    }
+    tape.Rewind();
+    for (int32_t expected = 0; expected < 100; ++expected) {
+        int32_t value = 0;
+        ASSERT_TRUE(tape.Read(value));
+        EXPECT_EQ(value, expected);
+        tape.Move(MoveDirection::kForward);
+    }
+    EXPECT_GT(stats.faults, 0);
+    EXPECT_EQ(stats.retries, stats.faults);
+}
+
+TEST(RetryingTapeTest, GivesUpAfterMaxAttempts) {
+    SimulationStats stats;
+    RetryingTape tape(std::make_unique<SimulatedTape>(std::make_unique<MemoryTape>(),
+                                                      FaultyModel(1, 0), &stats),
+                      3, &stats);
+    EXPECT_THROW(tape.Write(1), TapeFault);
+    EXPECT_EQ(stats.faults, 3);
+    EXPECT_EQ(stats.retries, 2);
+}
+
+TEST(SimulatedTapeTest, SortsThroughFaultyTapesWithRetries) {
+    std::mt19937 rng(11);
+    std::vector<int32_t> values(5000);
+    for (auto& value : values) {
+        value = static_cast<int32_t>(rng());
+    }
+
+    auto const sort = [&values](TapeModel const& model, SimulationStats& stats) {
+        MemoryTape input(values);
+        MemoryTape output;
+        auto factory = std::make_unique<SimulatedTapeFactory>(
+                std::make_unique<MemoryTapeFactory>(), model, &stats, 10);
+        TapeSorter sorter(256, std::move(factory));
+        sorter.Sort(input, output);
+        return output.GetData();
+    };
+
+    TapeModel model = FaultyModel(0.01, 5);
+    model.delays.move_delay_ms_ = milliseconds(1);
+    model.start_delay = microseconds(300);
+    model.jitter_percent = 10;
+
+    SimulationStats first;
+    auto const sorted = sort(model, first);
+    auto expected = values;
+    std::ranges::sort(expected);
+    EXPECT_EQ(sorted, expected);
+    EXPECT_GT(first.retries, 0);
+
+    SimulationStats second;
+    sort(model, second);
+    EXPECT_EQ(second.Elapsed(), first.Elapsed());
+    EXPECT_EQ(second.retries, first.retries);
+}
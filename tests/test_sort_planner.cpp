@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "sort_planner.h"
+
+class SortPlannerTest : public ::testing::Test {
+protected:
+    PlanRequest request_;
+
+    void SetUp() override {
+        request_.elements = 1'000'000;
+        request_.memory_bytes = 1 << 20;
+        request_.delays = TapeDelays(std::chrono::milliseconds(5), std::chrono::milliseconds(10),
+                                     std::chrono::milliseconds(50), std::chrono::milliseconds(2));
+    }
+};
+
+TEST_F(SortPlannerTest, UsesWholeMemoryBudgetForBlocks) {
+    auto const plan = SortPlanner::Plan(request_);
+
+    EXPECT_EQ(plan.block_size, TapeSorter::MaxBlockSize(request_.memory_bytes));
+    EXPECT_EQ(plan.passes, 1);
+    EXPECT_EQ(plan.strategy, MergeStrategy::kReadBackward);
+}
+
+TEST_F(SortPlannerTest, DoesNotExceedInputSize) {
+    request_.elements = 10;
+
+    EXPECT_EQ(SortPlanner::Plan(request_).block_size, 10);
+}
+
+TEST_F(SortPlannerTest, LimitsFanInByTapeCount) {
+    request_.memory_bytes = 4096;
+    request_.max_tapes = 5;
+    auto const plan = SortPlanner::Plan(request_);
+
+    ASSERT_GT(plan.fan_in, 0);
+    EXPECT_LE(plan.fan_in, 4);
+    EXPECT_EQ(plan.passes, TapeSorter::CountPasses(plan.runs, plan.fan_in));
+}
+
+TEST_F(SortPlannerTest, MergesInOnePassWhenTapesSuffice) {
+    request_.max_tapes = 6;
+    auto const plan = SortPlanner::Plan(request_);
+
+    EXPECT_EQ(plan.runs, 5);
+    EXPECT_EQ(plan.fan_in, 0);
+    EXPECT_EQ(plan.passes, 1);
+}
+
+TEST_F(SortPlannerTest, KeepsFixedBlockSize) {
+    request_.block_size = 1000;
+    auto const plan = SortPlanner::Plan(request_);
+
+    EXPECT_EQ(plan.block_size, 1000);
+    EXPECT_EQ(plan.runs, 1000);
+}
+
+TEST_F(SortPlannerTest, PlansUnknownSizeFromMemoryAndTapes) {
+    request_.max_tapes = 5;
+    auto plan = SortPlanner::PlanUnknownSize(request_);
+
+    EXPECT_EQ(plan.block_size, TapeSorter::MaxBlockSize(request_.memory_bytes));
+    EXPECT_EQ(plan.fan_in, 4);
+    EXPECT_EQ(plan.strategy, MergeStrategy::kReadBackward);
+
+    request_.block_size = 1000;
+    EXPECT_EQ(SortPlanner::PlanUnknownSize(request_).block_size, 1000);
+}
+
+TEST_F(SortPlannerTest, MorePassesCostMore) {
+    auto const one_pass = SortPlanner::Evaluate(request_, 1000, 0, MergeStrategy::kReadBackward);
+    auto const two_passes =
+            SortPlanner::Evaluate(request_, 1000, 32, MergeStrategy::kReadBackward);
+    auto const rewinding = SortPlanner::Evaluate(request_, 1000, 32, MergeStrategy::kRewind);
+
+    EXPECT_EQ(two_passes.passes, 2);
+    EXPECT_LT(one_pass.predicted_time, two_passes.predicted_time);
+    EXPECT_LT(two_passes.predicted_time, rewinding.predicted_time);
+}
+
+TEST_F(SortPlannerTest, ExplainPrintsPlan) {
+    std::ostringstream out;
+    SortPlanner::Explain(out, request_, SortPlanner::Plan(request_));
+
+    EXPECT_NE(out.str().find("block size"), std::string::npos);
+    EXPECT_NE(out.str().find("read-backward"), std::string::npos);
+}
@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+#include "memory_tape.h"
+#include "sort_progress.h"
+#include "tape_sorter.h"
+
+TEST(SortProgressTest, CountsSplitAndMergeWork) {
+    std::vector<int32_t> input(100);
+    std::iota(input.rbegin(), input.rend(), 0);
+    MemoryTape input_tape(input);
+    MemoryTape output_tape;
+
+    SortProgress progress(input.size());
+    SortOptions options{3, input.size(), MergeStrategy::kReadBackward};
+    options.progress = &progress;
+    TapeSorter sorter(10, std::make_unique<MemoryTapeFactory>(), options);
+    sorter.Sort(input_tape, output_tape);
+
+    auto const snapshot = progress.Snapshot();
+    EXPECT_EQ(snapshot.phase, SortPhase::kDone);
+    EXPECT_EQ(snapshot.elements_split, 100);
+    EXPECT_EQ(snapshot.runs_written, 10);
+    EXPECT_EQ(snapshot.merge_passes, TapeSorter::CountPasses(10, 3));
+    EXPECT_EQ(snapshot.merge_pass, snapshot.merge_passes);
+    EXPECT_EQ(snapshot.elements_merged, 100 * snapshot.merge_passes);
+    EXPECT_EQ(snapshot.Fraction(), 1.0);
+}
+
+TEST(SortProgressTest, FractionAndEtaFollowWorkDone) {
+    ProgressSnapshot snapshot;
+    snapshot.elapsed = ProgressSnapshot::Duration(10);
+    EXPECT_FALSE(snapshot.Fraction().has_value());
+    EXPECT_FALSE(snapshot.Eta().has_value());
+
+    snapshot.expected_elements = 100;
+    snapshot.elements_split = 50;
+    EXPECT_DOUBLE_EQ(*snapshot.Fraction(), 0.25);
+    EXPECT_DOUBLE_EQ(snapshot.Eta()->count(), 30);
+    EXPECT_DOUBLE_EQ(snapshot.Throughput(), 5);
+
+    snapshot.phase = SortPhase::kMerge;
+    snapshot.elements_split = 100;
+    snapshot.merge_passes = 3;
+    snapshot.elements_merged = 100;
+    EXPECT_DOUBLE_EQ(*snapshot.Fraction(), 0.5);
+}
+
+TEST(SortProgressTest, ReporterDeliversFinalSnapshot) {
+    SortProgress progress(1);
+    std::vector<ProgressSnapshot> snapshots;
+    {
+        ProgressReporter reporter(progress, std::chrono::hours(1),
+                                  [&snapshots](ProgressSnapshot const& snapshot) {
+                                      snapshots.push_back(snapshot);
+                                  });
+        progress.AddSplit();
+        progress.Finish();
+    }
+
+    ASSERT_EQ(snapshots.size(), 1);
+    EXPECT_EQ(snapshots.back().phase, SortPhase::kDone);
+    EXPECT_EQ(snapshots.back().elements_split, 1);
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <gtest/gtest.h>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "memory_tape.h"
+#include "stream_tape.h"
+#include "tape_sorter.h"
+
+class StreamTapeTest : public testing::Test {
+protected:
+    void SetUp() override {
+        file_.reset(std::tmpfile());
+        ASSERT_NE(file_, nullptr);
+    }
+
+    void Put(std::string const& contents) {
+        std::fwrite(contents.data(), 1, contents.size(), file_.get());
+        std::rewind(file_.get());
+    }
+
+    std::string Contents() {
+        std::rewind(file_.get());
+        std::string contents;
+        char chunk[256];
+        while (size_t const count = std::fread(chunk, 1, sizeof(chunk), file_.get())) {
+            contents.append(chunk, count);
+        }
+        return contents;
+    }
+
+    static std::vector<int32_t> ReadAll(ITape& tape) {
+        std::vector<int32_t> values;
+        int32_t value;
+        while (tape.Read(value)) {
+            values.push_back(value);
+            tape.Move(MoveDirection::kForward);
+        }
+        return values;
+    }
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file_{nullptr, std::fclose};
+};
+
+TEST_F(StreamTapeTest, ParsesTextAcrossBufferBoundaries) {
+    std::vector<int32_t> expected(5000);
+    std::iota(expected.begin(), expected.end(), -2500);
+    expected.push_back(std::numeric_limits<int32_t>::min());
+    expected.push_back(std::numeric_limits<int32_t>::max());
+    std::string text;
+    for (int32_t value : expected) {
+        text += std::to_string(value) + (value % 7 == 0 ? "\n\t" : " ");
+    }
+    Put(text + "+42");
+    expected.push_back(42);
+
+    StreamInputTape tape(file_.get(), StreamFormat::kText, TapeDelays{}, nullptr, nullptr,
+                         StreamInputTape::kMinBufferBytes);
+    tape.Rewind();
+    int32_t value;
+    ASSERT_TRUE(tape.Read(value));
+    ASSERT_TRUE(tape.Read(value));
+    EXPECT_EQ(value, expected.front());
+    EXPECT_EQ(ReadAll(tape), expected);
+    EXPECT_THROW(tape.Rewind(), std::runtime_error);
+    EXPECT_THROW(tape.Move(MoveDirection::kBackward), std::runtime_error);
+}
+
+TEST_F(StreamTapeTest, RejectsMalformedInput) {
+    Put("1 2 x3");
+    StreamInputTape text(file_.get(), StreamFormat::kText, TapeDelays{});
+    EXPECT_THROW(ReadAll(text), std::runtime_error);
+
+    file_.reset(std::tmpfile());
+    Put(std::string(6, '\0'));
+    StreamInputTape binary(file_.get(), StreamFormat::kBinary, TapeDelays{});
+    EXPECT_THROW(ReadAll(binary), std::runtime_error);
+}
+
+TEST_F(StreamTapeTest, WritesTextAndBinary) {
+    {
+        StreamOutputTape tape(file_.get(), StreamFormat::kText, TapeDelays{}, nullptr, nullptr, 2);
+        tape.Rewind();
+        for (int32_t value : {3, -1, 7}) {
+            tape.Write(value);
+            tape.Move(MoveDirection::kForward);
+        }
+        int32_t value;
+        EXPECT_FALSE(tape.Read(value));
+        EXPECT_THROW(tape.Rewind(), std::runtime_error);
+        tape.Write(8);
+    }
+    EXPECT_EQ(Contents(), "3 -1\n7 8\n");
+
+    file_.reset(std::tmpfile());
+    {
+        StreamOutputTape tape(file_.get(), StreamFormat::kBinary, TapeDelays{});
+        tape.Write(0x01020304);
+        tape.Move(MoveDirection::kForward);
+        EXPECT_THROW(tape.Move(MoveDirection::kForward), std::runtime_error);
+    }
+    int32_t const expected = 0x01020304;
+    EXPECT_EQ(Contents(), std::string(reinterpret_cast<char const*>(&expected), sizeof(expected)));
+}
+
+TEST_F(StreamTapeTest, SorterStreamsBinaryInputToOutput) {
+    std::vector<int32_t> input(20000);
+    std::iota(input.rbegin(), input.rend(), -10000);
+    Put(std::string(reinterpret_cast<char const*>(input.data()), input.size() * sizeof(int32_t)));
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> output(std::tmpfile(), std::fclose);
+    SortVerifier verifier;
+    {
+        StreamInputTape input_tape(file_.get(), StreamFormat::kBinary, TapeDelays{}, nullptr,
+                                   &verifier);
+        StreamOutputTape output_tape(output.get(), StreamFormat::kBinary, TapeDelays{}, nullptr,
+                                     &verifier);
+        TapeSorter sorter(1000, std::make_unique<MemoryTapeFactory>(),
+                          SortOptions{4, 0, MergeStrategy::kReadBackward});
+        sorter.Sort(input_tape, output_tape);
+    }
+    EXPECT_NO_THROW(verifier.Check());
+
+    file_ = std::move(output);
+    std::string const contents = Contents();
+    std::vector<int32_t> sorted(contents.size() / sizeof(int32_t));
+    std::memcpy(sorted.data(), contents.data(), contents.size());
+    std::sort(input.begin(), input.end());
+    EXPECT_EQ(sorted, input);
+}
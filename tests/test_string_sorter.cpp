@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "memory_tape.h"
+#include "string_sorter.h"
+
+namespace {
+std::vector<int32_t> Encode(std::vector<StringRecord> const& records) {
+    MemoryTape tape;
+    for (auto const& record : records) {
+        WriteStringRecord(tape, record.key, record.payload);
+    }
+    return tape.GetData();
+}
+
+std::vector<StringRecord> Decode(std::vector<int32_t> const& cells) {
+    MemoryTape tape(cells);
+    std::vector<StringRecord> records;
+    StringRecord record;
+    while (ReadStringRecord(tape, record)) {
+        records.push_back(record);
+    }
+    return records;
+}
+
+// Keys share long prefixes and repeat, most payloads record the input position.
+std::vector<StringRecord> RandomRecords(size_t const count) {
+    std::mt19937 random(13);
+    std::vector<std::string> const stems = {"", "a", "ab", "abcdefgh", "abcdefghij", "zz\xff"};
+    std::uniform_int_distribution<size_t> stem(0, stems.size() - 1);
+    std::uniform_int_distribution<int> suffix_length(0, 3);
+    std::uniform_int_distribution<int> letter(0, 2);
+    std::vector<StringRecord> records;
+    for (size_t idx = 0; idx < count; ++idx) {
+        std::string key = stems[stem(random)];
+        for (int length = suffix_length(random); length > 0; --length) {
+            key.push_back(letter(random) == 0 ? '\0' : static_cast<char>('a' + letter(random)));
+        }
+        // Empty records take no bytes in the split buffer.
+        std::string payload = idx % 5 == 0 ? "" : std::string(idx % 7, 'p') + std::to_string(idx);
+        records.push_back({key, payload});
+    }
+    return records;
+}
+
+std::vector<StringRecord> StableSorted(std::vector<StringRecord> records) {
+    std::ranges::stable_sort(records, {}, &StringRecord::key);
+    return records;
+}
+}  // namespace
+
+TEST(StringSorterTest, RecordsRoundTripThroughTape) {
+    std::vector<StringRecord> const records = {
+            {"", ""}, {"key", "value"}, {"abcd", "1234"}, {std::string("a\0b", 3), "x"}};
+    EXPECT_EQ(Decode(Encode(records)), records);
+    // Key and payload lengths at both ends, "key" in one cell and "value" in two.
+    EXPECT_EQ(Encode({records[1]}).size(), 7);
+}
+
+TEST(StringSorterTest, PrefixesOrderLikeKeys) {
+    EXPECT_LT(StringSorter::KeyPrefix("a"), StringSorter::KeyPrefix("b"));
+    EXPECT_LT(StringSorter::KeyPrefix("ab"), StringSorter::KeyPrefix("abc"));
+    EXPECT_LT(StringSorter::KeyPrefix("a"), StringSorter::KeyPrefix("\xff"));
+    EXPECT_EQ(StringSorter::KeyPrefix("abcdefgh1"), StringSorter::KeyPrefix("abcdefgh2"));
+    EXPECT_EQ(StringSorter::KeyPrefix("ab"), StringSorter::KeyPrefix(std::string("ab\0", 3)));
+}
+
+TEST(StringSorterTest, SortHandlesEmptyInput) {
+    MemoryTape input_tape;
+    MemoryTape output_tape;
+
+    StringSorter sorter(64, std::make_unique<MemoryTapeFactory>());
+    sorter.Sort(input_tape, output_tape);
+
+    EXPECT_TRUE(output_tape.GetData().empty());
+}
+
+TEST(StringSorterTest, SortIsStableAcrossBlocksAndPasses) {
+    auto const records = RandomRecords(300);
+    auto const expected = StableSorted(records);
+
+    for (size_t block : {1, 100, 1000, 100000}) {
+        for (size_t fan_in : {0, 2, 3}) {
+            for (auto strategy : {MergeStrategy::kReadBackward, MergeStrategy::kRewind}) {
+                MemoryTape input_tape(Encode(records));
+                MemoryTape output_tape;
+
+                StringSorter sorter(block, std::make_unique<MemoryTapeFactory>(),
+                                    SortOptions{fan_in, 0, strategy});
+                sorter.Sort(input_tape, output_tape);
+
+                EXPECT_EQ(Decode(output_tape.GetData()), expected)
+                        << "block " << block << ", fan-in " << fan_in;
+            }
+        }
+    }
+}
+
+TEST(StringSorterTest, SortsLargeBlocksOnSeveralThreads) {
+    auto const records = RandomRecords(5000);
+    MemoryTape input_tape(Encode(records));
+    MemoryTape output_tape;
+
+    SortOptions options;
+    options.sort_threads = 4;
+    options.expected_elements = input_tape.GetData().size();
+    StringSorter sorter(size_t{1} << 20, std::make_unique<MemoryTapeFactory>(), options);
+    sorter.Sort(input_tape, output_tape);
+
+    EXPECT_EQ(Decode(output_tape.GetData()), StableSorted(records));
+}
+
+TEST(StringSorterTest, SortsWithinMemoryBudget) {
+    std::vector<StringRecord> records = RandomRecords(2000);
+    records.push_back({std::string(5000, 'k'), std::string(3000, 'v')});
+
+    MemoryBudget budget(64 * 1024);
+    SortOptions options;
+    options.memory_budget = &budget;
+    MemoryTape input_tape(Encode(records));
+    MemoryTape output_tape;
+
+    StringSorter sorter(size_t{1} << 30, std::make_unique<MemoryTapeFactory>(), options);
+    sorter.Sort(input_tape, output_tape);
+
+    EXPECT_EQ(Decode(output_tape.GetData()), StableSorted(records));
+    EXPECT_EQ(budget.Used(), 0);
+}
+
+TEST(StringSorterTest, OversizedRecordDoesNotGrowLaterBlocks) {
+    auto const count_runs = [](std::vector<StringRecord> const& records) {
+        MemoryTape input_tape(Encode(records));
+        MemoryTape output_tape;
+        SortProgress progress;
+        SortOptions options;
+        options.progress = &progress;
+
+        StringSorter sorter(256, std::make_unique<MemoryTapeFactory>(), options);
+        sorter.Sort(input_tape, output_tape);
+        EXPECT_EQ(Decode(output_tape.GetData()), StableSorted(records));
+        return progress.Snapshot().runs_written;
+    };
+
+    auto records = RandomRecords(200);
+    size_t const runs = count_runs(records);
+    records.insert(records.begin(), {std::string(2000, 'k'), "v"});
+    EXPECT_EQ(count_runs(records), runs + 1);
+}
+
+TEST(StringSorterTest, ThrowsOnTruncatedRecord) {
+    auto cells = Encode({{"truncated", "record"}});
+    cells.pop_back();
+    MemoryTape input_tape(cells);
+    MemoryTape output_tape;
+
+    StringSorter sorter(64, std::make_unique<MemoryTapeFactory>());
+    EXPECT_THROW(sorter.Sort(input_tape, output_tape), std::runtime_error);
+}
@@ -2,63 +2,13 @@
 #include <fstream>
 #include <gtest/gtest.h>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <vector>
 
-#include "i_tape.h"
+#include "memory_tape.h"
 #include "tape_sorter.h"
 
-class MemoryTape : public ITape {
-public:
-    explicit MemoryTape(std::vector<int32_t> const& initial_data = {})
-        : data_(initial_data), position_(0) {}
-
-    bool Read(int32_t& value) override {
-        if (position_ >= data_.size()) {
-            return false;
-        }
-        value = data_[position_];
-        return true;
-    }
-
-    void Write(int32_t value) override {
-        if (position_ >= data_.size()) {
-            data_.push_back(value);
-        } else {
-            data_[position_] = value;
-        }
-    }
-
-    void Move(MoveDirection direction) override {
-        if (direction == MoveDirection::kForward) {
-            position_++;
-        } else if (position_ > 0) {
-            position_--;
-        } else {
-            throw std::out_of_range("Cannot move backward at position 0");
-        }
-    }
-
-    void Rewind() override {
-        position_ = 0;
-    }
-
-    [[nodiscard]] std::vector<int32_t> const& GetData() const {
-        return data_;
-    }
-
-private:
-    std::vector<int32_t> data_;
-    size_t position_;
-};
-
-class MemoryTapeFactory : public ITapeFactory {
-public:
-    std::unique_ptr<ITape> Create() override {
-        return std::make_unique<MemoryTape>();
-    }
-};
-
 class TapeSorterTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -201,3 +151,210 @@ TEST_F(TapeSorterTest, SortHandlesIntMinMaxValues) {
         EXPECT_EQ(output_tape->GetData()[i], expected[i]);
     }
 }
+
+class RewindCountingTape : public MemoryTape {
+public:
+    RewindCountingTape(std::vector<int32_t> const& data, size_t& rewinds)
+        : MemoryTape(data), rewinds_(rewinds) {}
+
+    void Rewind() override {
+        ++rewinds_;
+        MemoryTape::Rewind();
+    }
+
+private:
+    size_t& rewinds_;
+};
+
+class RewindCountingTapeFactory : public ITapeFactory {
+public:
+    explicit RewindCountingTapeFactory(size_t& rewinds) : rewinds_(rewinds) {}
+
+    std::unique_ptr<ITape> Create() override {
+        return std::make_unique<RewindCountingTape>(std::vector<int32_t>{}, rewinds_);
+    }
+
+private:
+    size_t& rewinds_;
+};
+
+TEST_F(TapeSorterTest, SortReadsRunsBackwardWithoutRewinding) {
+    size_t input_rewinds = 0;
+    size_t tmp_rewinds = 0;
+    RewindCountingTape input_tape({9, 7, 5, 3, 1, 8, 6, 4, 2}, input_rewinds);
+    MemoryTape output_tape;
+
+    TapeSorter sorter(2, std::make_unique<RewindCountingTapeFactory>(tmp_rewinds));
+    sorter.Sort(input_tape, output_tape);
+
+    EXPECT_EQ(output_tape.GetData(), (std::vector<int32_t>{1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(input_rewinds, 1);
+    EXPECT_EQ(tmp_rewinds, 0);
+}
+
+TEST_F(TapeSorterTest, SortWithLimitedFanIn) {
+    std::vector<int32_t> input = {9, 7, 5, 3, 1, 8, 6, 4, 2, 0, -1};
+    std::vector<int32_t> expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    for (size_t fan_in : {2, 3, 4}) {
+        for (auto strategy : {MergeStrategy::kReadBackward, MergeStrategy::kRewind}) {
+            MemoryTape input_tape(input);
+            MemoryTape output_tape;
+
+            TapeSorter sorter(1, std::make_unique<MemoryTapeFactory>(),
+                              SortOptions{fan_in, 0, strategy});
+            sorter.Sort(input_tape, output_tape);
+
+            EXPECT_EQ(output_tape.GetData(), expected);
+        }
+    }
+}
+
+TEST_F(TapeSorterTest, ExpectedSizeAvoidsRewindsOnEvenPassCount) {
+    size_t input_rewinds = 0;
+    size_t tmp_rewinds = 0;
+    std::vector<int32_t> input = {9, 7, 5, 3, 1, 8, 6, 4};
+    RewindCountingTape input_tape(input, input_rewinds);
+    MemoryTape output_tape;
+
+    ASSERT_EQ(TapeSorter::CountPasses(4, 2), 2);
+    TapeSorter sorter(2, std::make_unique<RewindCountingTapeFactory>(tmp_rewinds),
+                      SortOptions{2, input.size(), MergeStrategy::kReadBackward});
+    sorter.Sort(input_tape, output_tape);
+
+    EXPECT_EQ(output_tape.GetData(), (std::vector<int32_t>{1, 3, 4, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(tmp_rewinds, 0);
+}
+
+TEST_F(TapeSorterTest, ExpectedSizeUsesBlockSizeShrunkByBudget) {
+    size_t input_rewinds = 0;
+    size_t tmp_rewinds = 0;
+    MemoryBudget budget(128);
+    size_t const block_size = TapeSorter::MaxBlockSize(budget.Limit());
+    std::vector<int32_t> input(4 * block_size);
+    std::iota(input.rbegin(), input.rend(), 0);
+    RewindCountingTape input_tape(input, input_rewinds);
+    MemoryTape output_tape;
+
+    // The budget leaves room for four runs merged in two passes, not for one run in one pass.
+    SortOptions options{2, input.size(), MergeStrategy::kReadBackward};
+    options.memory_budget = &budget;
+    TapeSorter sorter(input.size(), std::make_unique<RewindCountingTapeFactory>(tmp_rewinds),
+                      options);
+    sorter.Sort(input_tape, output_tape);
+
+    std::sort(input.begin(), input.end());
+    EXPECT_EQ(output_tape.GetData(), input);
+    EXPECT_EQ(tmp_rewinds, 0);
+}
+
+TEST_F(TapeSorterTest, CountPasses) {
+    EXPECT_EQ(TapeSorter::CountPasses(100, 0), 1);
+    EXPECT_EQ(TapeSorter::CountPasses(4, 4), 1);
+    EXPECT_EQ(TapeSorter::CountPasses(5, 4), 2);
+    EXPECT_EQ(TapeSorter::CountPasses(17, 4), 3);
+    EXPECT_EQ(TapeSorter::CountPasses(4, 4, 1), 1);
+    EXPECT_EQ(TapeSorter::CountPasses(6, 3, 2), 3);
+}
+
+TEST_F(TapeSorterTest, MergeSortedMergesPresortedTapes) {
+    MemoryTape first(std::vector<int32_t>{1, 4, 7, 10});
+    MemoryTape second(std::vector<int32_t>{-3, 2, 2, 8});
+    MemoryTape empty;
+    MemoryTape third(std::vector<int32_t>{5});
+    MemoryTape output_tape;
+
+    TapeSorter sorter(1, std::make_unique<MemoryTapeFactory>());
+    sorter.MergeSorted({&first, &second, &empty, &third}, output_tape);
+
+    EXPECT_EQ(output_tape.GetData(), (std::vector<int32_t>{-3, 1, 2, 2, 4, 5, 7, 8, 10}));
+}
+
+TEST_F(TapeSorterTest, MergeSortedWithLimitedFanIn) {
+    std::vector<std::vector<int32_t>> inputs = {{1, 9}, {2, 8}, {3, 7}, {4, 6}, {5}, {0, 10}};
+    std::vector<int32_t> expected;
+    for (auto const& input : inputs) {
+        expected.insert(expected.end(), input.begin(), input.end());
+    }
+    std::sort(expected.begin(), expected.end());
+
+    for (size_t fan_in : {2, 3, 4}) {
+        for (auto strategy : {MergeStrategy::kReadBackward, MergeStrategy::kRewind}) {
+            std::vector<MemoryTape> tapes(inputs.begin(), inputs.end());
+            std::vector<ITape*> input_tapes;
+            for (auto& tape : tapes) {
+                input_tapes.push_back(&tape);
+            }
+            MemoryTape output_tape;
+
+            TapeSorter sorter(1, std::make_unique<MemoryTapeFactory>(),
+                              SortOptions{fan_in, 0, strategy});
+            sorter.MergeSorted(input_tapes, output_tape);
+
+            EXPECT_EQ(output_tape.GetData(), expected);
+        }
+    }
+}
+
+TEST_F(TapeSorterTest, MergeSortedRejectsUnsortedInput) {
+    MemoryTape sorted(std::vector<int32_t>{1, 2, 3});
+    MemoryTape unsorted(std::vector<int32_t>{1, 5, 4});
+    MemoryTape output_tape;
+
+    TapeSorter sorter(1, std::make_unique<MemoryTapeFactory>());
+    EXPECT_THROW(sorter.MergeSorted({&sorted, &unsorted}, output_tape), std::runtime_error);
+}
+
+TEST_F(TapeSorterTest, SortIncrementalMergesDeltaWithSortedTape) {
+    std::vector<int32_t> sorted = {-4, 0, 3, 3, 8, 12};
+    std::vector<int32_t> delta = {9, 3, -7, 15, 1, 0, 6};
+    std::vector<int32_t> expected = sorted;
+    expected.insert(expected.end(), delta.begin(), delta.end());
+    std::sort(expected.begin(), expected.end());
+
+    for (size_t fan_in : {0, 2, 3}) {
+        for (auto strategy : {MergeStrategy::kReadBackward, MergeStrategy::kRewind}) {
+            size_t sorted_rewinds = 0;
+            RewindCountingTape sorted_tape(sorted, sorted_rewinds);
+            MemoryTape input_tape(delta);
+            MemoryTape output_tape;
+
+            TapeSorter sorter(2, std::make_unique<MemoryTapeFactory>(),
+                              SortOptions{fan_in, 0, strategy});
+            sorter.SortIncremental(sorted_tape, input_tape, output_tape);
+
+            EXPECT_EQ(output_tape.GetData(), expected);
+            EXPECT_EQ(sorted_rewinds, 1);
+        }
+    }
+}
+
+TEST_F(TapeSorterTest, SortIncrementalCountsSortedTapeInPasses) {
+    size_t input_rewinds = 0;
+    size_t tmp_rewinds = 0;
+    std::vector<int32_t> delta = {9, 3, -7, 15};
+    RewindCountingTape input_tape(delta, input_rewinds);
+    MemoryTape sorted_tape(std::vector<int32_t>{-4, 0, 3, 8});
+    MemoryTape output_tape;
+
+    // Two delta runs and the sorted tape need two passes with fan-in 2, not one.
+    ASSERT_EQ(TapeSorter::CountPasses(3, 2, 1), 2);
+    TapeSorter sorter(2, std::make_unique<RewindCountingTapeFactory>(tmp_rewinds),
+                      SortOptions{2, delta.size(), MergeStrategy::kReadBackward});
+    sorter.SortIncremental(sorted_tape, input_tape, output_tape);
+
+    EXPECT_EQ(output_tape.GetData(), (std::vector<int32_t>{-7, -4, 0, 3, 3, 8, 9, 15}));
+    EXPECT_EQ(tmp_rewinds, 0);
+}
+
+TEST_F(TapeSorterTest, SortIncrementalWithEmptyDelta) {
+    MemoryTape sorted_tape(std::vector<int32_t>{1, 2, 3});
+    MemoryTape input_tape;
+    MemoryTape output_tape;
+
+    TapeSorter sorter(2, std::make_unique<MemoryTapeFactory>());
+    sorter.SortIncremental(sorted_tape, input_tape, output_tape);
+
+    EXPECT_EQ(output_tape.GetData(), (std::vector<int32_t>{1, 2, 3}));
+}
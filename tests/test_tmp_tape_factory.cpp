@@ -89,3 +89,44 @@ TEST_F(TmpTapeFactoryTest, CleanupTempFilesRemovesFiles) {
                                std::filesystem::directory_iterator{});
     EXPECT_EQ(file_count, 0);
 }
+
+TEST_F(TmpTapeFactoryTest, StripesTapesAcrossDirectoriesRoundRobin) {
+    std::vector<std::string> const dirs = {(test_dir_ / "a").string(), (test_dir_ / "b").string(),
+                                           (test_dir_ / "c").string()};
+    {
+        TmpTapeFactory factory(dirs, test_delays_);
+        std::vector<std::unique_ptr<ITape>> tapes;
+        for (int idx = 0; idx < 7; ++idx) {
+            tapes.push_back(factory.Create());
+        }
+
+        std::vector<size_t> counts;
+        for (auto const& dir : dirs) {
+            counts.push_back(std::distance(std::filesystem::directory_iterator(dir),
+                                           std::filesystem::directory_iterator{}));
+        }
+        EXPECT_EQ(counts, (std::vector<size_t>{3, 2, 2}));
+    }
+    for (auto const& dir : dirs) {
+        EXPECT_TRUE(std::filesystem::is_empty(dir));
+    }
+}
+
+TEST_F(TmpTapeFactoryTest, FreeSpacePlacementUsesListedDirectories) {
+    std::vector<std::string> const dirs = {(test_dir_ / "a").string(), (test_dir_ / "b").string()};
+    TmpTapeFactory factory(dirs, test_delays_, nullptr, TapeBackend::kStream,
+                           TapePlacement::kFreeSpace);
+    auto tape1 = factory.Create();
+    auto tape2 = factory.Create();
+
+    size_t file_count = 0;
+    for (auto const& dir : dirs) {
+        file_count += std::distance(std::filesystem::directory_iterator(dir),
+                                    std::filesystem::directory_iterator{});
+    }
+    EXPECT_EQ(file_count, 2);
+}
+
+TEST_F(TmpTapeFactoryTest, RequiresADirectory) {
+    EXPECT_THROW(TmpTapeFactory(std::vector<std::string>{}, test_delays_), std::invalid_argument);
+}